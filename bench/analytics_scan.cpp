@@ -0,0 +1,81 @@
+// Отчёт по загрузке и выручке за год: столбцовый Analytics::build против
+// обхода объектов Reservation по одному на N бронях (по умолчанию 10M).
+//   analytics_scan [броней]
+#include "bench.h"
+#include "../include/core/Analytics.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+
+int main(int argc, char* argv[]) {
+    const size_t count = bench::size_arg(argc, argv, 10000000);
+    constexpr int seats = 60;
+    constexpr time_t day = 86400;
+    const time_t to = 1792240000;
+    const time_t from = to - 365 * day;
+
+    PersistentIdMap<Seat>::Builder builder;
+    for(int id = 1; id <= seats; ++id) {
+        builder.insert_or_assign(id, Seat(id, static_cast<Seat::Type>(id % 4), Seat::Status::Free));
+    }
+    const auto seat_map = builder.build();
+
+    std::mt19937_64 random(1);
+    ReservationColumns columns;
+    columns.reserve(count);
+    std::vector<Reservation> rows;
+    rows.reserve(count);
+    for(size_t i = 0; i < count; ++i) {
+        const time_t start = from - 3600 + static_cast<time_t>(random() % (365ull * day));
+        const Reservation reservation(static_cast<int>(i + 1), static_cast<int>(random() % 1000),
+                                      1 + static_cast<int>(random() % seats), start,
+                                      start + 1800 + static_cast<time_t>(random() % (4 * 3600)),
+                                      static_cast<Reservation::Status>(random() % 4), 100.0);
+        columns.push_back(reservation);
+        rows.push_back(reservation);
+    }
+
+    const auto report = Analytics::build(columns, seat_map, from, to);
+    bench::report("columnar scan", report.seconds * 1e3, "ms");
+    bench::report("columnar throughput", count / report.seconds / 1e6, "M rows/s");
+
+    // Прежний путь: объект за объектом. Начала местных суток посчитаны
+    // заранее, сутки брони ищутся двоичным поиском
+    std::vector<time_t> days;
+    for(time_t t = from - day; t < to + day; t += day) {
+        std::tm local{};
+        localtime_r(&t, &local);
+        local.tm_hour = local.tm_min = local.tm_sec = 0;
+        local.tm_isdst = -1;
+        const time_t midnight = std::mktime(&local);
+        if(days.empty() || days.back() != midnight) days.push_back(midnight);
+    }
+    auto started = bench::Clock::now();
+    std::map<int, double> type_seconds;
+    std::map<time_t, double> revenue;
+    for(const auto& r : rows) {
+        if(r.status() == Reservation::Status::Cancelled) continue;
+        const time_t start = std::max(r.start_time(), from);
+        const time_t end = std::min(r.end_time(), to);
+        if(start < end) type_seconds[static_cast<int>(seat_map.at(r.seat_id()).type())] += end - start;
+        if(r.start_time() >= from && r.start_time() < to) {
+            const auto next = std::upper_bound(days.begin(), days.end(), r.start_time());
+            revenue[*(next - 1)] += r.total_cost();
+        }
+    }
+    const double row_seconds = bench::seconds_since(started);
+    bench::report("row-by-row scan", row_seconds * 1e3, "ms");
+    bench::report("row-by-row throughput", count / row_seconds / 1e6, "M rows/s");
+
+    double expected = 0.0;
+    for(const auto& [day_start, amount] : revenue) expected += amount;
+    double reported = 0.0;
+    for(const auto& daily : report.revenue) reported += daily.revenue;
+    double mismatched_hours = 0.0;
+    for(const auto& type : report.by_type) {
+        mismatched_hours += std::fabs(type.occupied_hours - type_seconds[static_cast<int>(type.type)] / 3600.0);
+    }
+    std::printf("revenue %.0f vs %.0f, hours difference %.3f\n", reported, expected, mismatched_hours);
+    return std::fabs(reported - expected) < 1.0 && mismatched_hours < 1e-3 ? 0 : 1;
+}
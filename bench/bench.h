@@ -0,0 +1,42 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Общее для замеров: таймер, перцентили и размер задачи из командной строки
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Первый аргумент программы или значение по умолчанию
+inline size_t size_arg(int argc, char* argv[], size_t fallback) {
+    return argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : fallback;
+}
+
+inline double percentile(std::vector<double> samples, double p) {
+    if(samples.empty()) return 0.0;
+    const auto at = static_cast<size_t>(p * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + at, samples.end());
+    return samples[at];
+}
+
+// Пустая база во временном каталоге: старые файлы прошлого запуска удаляются
+inline std::string temp_db(const std::string& name) {
+    const std::string path = "/tmp/club_bench_" + name + ".db";
+    for(const char* suffix : {"", "-wal", "-shm", ".snap"}) std::remove((path + suffix).c_str());
+    return path;
+}
+
+inline void report(const std::string& name, double value, const char* unit) {
+    std::printf("%-44s %14.3f %s\n", name.c_str(), value, unit);
+}
+
+}
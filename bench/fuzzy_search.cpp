@@ -0,0 +1,110 @@
+// Нечёткий поиск по именам: задержка FuzzyNameIndex::search на N клиентах
+// (по умолчанию 1M) против цели - однозначное число миллисекунд, и цена
+// одного расстояния - полная таблица против ограниченной полосы.
+//   fuzzy_search [клиентов]
+#include "bench.h"
+#include "../include/core/FuzzyNameIndex.h"
+#include "../include/core/Utf8.h"
+#include <random>
+
+namespace {
+
+constexpr double target_ms = 10.0;
+
+// Прежний расчёт: вся таблица и два новых вектора на вызов
+int full_distance(const std::u32string& a, const std::u32string& b) {
+    std::vector<int> previous(b.size() + 1);
+    std::vector<int> current(b.size() + 1);
+    for(size_t j = 0; j <= b.size(); ++j) previous[j] = static_cast<int>(j);
+    for(size_t i = 1; i <= a.size(); ++i) {
+        current[0] = static_cast<int>(i);
+        for(size_t j = 1; j <= b.size(); ++j) {
+            const int substitution = previous[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1);
+            current[j] = std::min({previous[j] + 1, current[j - 1] + 1, substitution});
+        }
+        std::swap(previous, current);
+    }
+    return previous[b.size()];
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    const size_t clients = bench::size_arg(argc, argv, 1000000);
+    const char* const first_names[] = {"Иван", "Пётр", "Анна", "Мария", "Олег",
+                                       "Денис", "Сергей", "Ольга", "Алексей", "Елена"};
+    const std::string letters = "абвгдежзиклмнопрстуфхцчшэюя";
+    std::mt19937 random(1);
+
+    // Фамилии - случайные 6-9 букв, кириллица в UTF-8 по два байта
+    std::vector<std::string> names;
+    names.reserve(clients);
+    for(size_t i = 0; i < clients; ++i) {
+        std::string name = first_names[random() % 10];
+        name += ' ';
+        for(size_t n = 6 + random() % 4; n > 0; --n) {
+            name.append(letters, 2 * (random() % (letters.size() / 2)), 2);
+        }
+        names.push_back(std::move(name));
+    }
+
+    auto started = bench::Clock::now();
+    FuzzyNameIndex index;
+    for(size_t i = 0; i < clients; ++i) index.add(static_cast<int>(i), names[i]);
+    bench::report("build index (" + std::to_string(clients) + " clients)", bench::seconds_since(started), "s");
+
+    // Запросы: имя с опечаткой в фамилии (замена буквы)
+    std::vector<std::string> queries;
+    for(int q = 0; q < 200; ++q) {
+        std::u32string name = Utf8::decode(names[random() % clients]);
+        const size_t space = name.find(U' ');
+        const size_t at = space + 1 + random() % (name.size() - space - 1);
+        name[at] = name[at] == U'а' ? U'о' : U'а';
+        std::string query;
+        for(char32_t c : name) Utf8::append(query, c);
+        queries.push_back(std::move(query));
+    }
+
+    // Имя целиком и одна фамилия - как вводят на стойке
+    std::vector<std::string> surnames;
+    for(const auto& query : queries) surnames.push_back(query.substr(query.find(' ') + 1));
+
+    bool met = true;
+    for(const auto* set : {&queries, &surnames}) {
+        for(int max_edits : {1, 2}) {
+            std::vector<double> latency;
+            size_t found = 0;
+            for(const auto& query : *set) {
+                started = bench::Clock::now();
+                found += index.search(query, max_edits, 10).size();
+                latency.push_back(bench::seconds_since(started) * 1e3);
+            }
+            const std::string label = std::string(set == &queries ? "name" : "surname") +
+                                      " max_edits=" + std::to_string(max_edits);
+            const double p99 = bench::percentile(latency, 0.99);
+            met = met && p99 < target_ms;
+            bench::report(label + " p50", bench::percentile(latency, 0.5), "ms");
+            bench::report(label + " p99", p99, "ms");
+            bench::report(label + " matches per query", static_cast<double>(found) / set->size(), "");
+        }
+    }
+    std::printf("target p99 < %.0f ms at %zu clients: %s\n", target_ms, clients, met ? "met" : "MISSED");
+
+    // Расстояние от слова запроса до случайных слов - то, что считает поиск
+    std::vector<std::u32string> words;
+    for(size_t i = 0; i < 100000; ++i) {
+        const std::u32string name = Utf8::fold_decode(names[random() % clients]);
+        words.push_back(name.substr(name.find(U' ') + 1));
+    }
+    const std::u32string probe = words[0];
+    long checksum = 0;
+    started = bench::Clock::now();
+    for(const auto& word : words) checksum += full_distance(probe, word) <= 2;
+    const double full = bench::seconds_since(started);
+    started = bench::Clock::now();
+    for(const auto& word : words) checksum -= FuzzyNameIndex::distance(probe, word, 2) <= 2;
+    const double bounded = bench::seconds_since(started);
+    bench::report("distance full table", full / words.size() * 1e9, "ns");
+    bench::report("distance bounded (bound 2)", bounded / words.size() * 1e9, "ns");
+    return checksum == 0 ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+// Хранилища сущностей по id: std::unordered_map (прежнее), плотная IdMap и
+// версионная PersistentIdMap (ClubSystem) - поиск и полный обход на 1k, 100k
+// и 1M клиентов.
+//   id_storage [наибольший размер]
+#include "bench.h"
+#include "../include/core/IdMap.h"
+#include "../include/core/PersistentIdMap.h"
+#include "../include/models/Client.h"
+#include <random>
+#include <unordered_map>
+
+namespace {
+
+constexpr size_t lookups = 2000000;
+
+template<typename Find>
+void measure_lookup(const std::string& label, const std::vector<int>& ids, Find&& find) {
+    size_t checksum = 0;
+    const auto started = bench::Clock::now();
+    for(int id : ids) checksum += find(id).contact().size();
+    bench::report(label + " lookup", bench::seconds_since(started) / ids.size() * 1e9, "ns");
+    if(checksum == 0) std::printf("empty\n");
+}
+
+template<typename Map, typename Get>
+void measure_scan(const std::string& label, const Map& map, size_t count, Get&& get) {
+    size_t checksum = 0;
+    const auto started = bench::Clock::now();
+    for(const auto& entry : map) checksum += get(entry).name().size();
+    bench::report(label + " scan", bench::seconds_since(started) / count * 1e9, "ns/item");
+    if(checksum == 0) std::printf("empty\n");
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    const size_t largest = bench::size_arg(argc, argv, 1000000);
+    std::mt19937 random(7);
+    for(size_t count : {size_t(1000), size_t(100000), size_t(1000000)}) {
+        if(count > largest) break;
+        std::unordered_map<int, Client> hashed;
+        IdMap<Client> dense;
+        PersistentIdMap<Client>::Builder builder;
+        for(size_t i = 1; i <= count; ++i) {
+            const int id = static_cast<int>(i);
+            char contact[16];
+            std::snprintf(contact, sizeof(contact), "+7%010zu", i);
+            const Client client(Client::trusted, id, "Клиент " + std::to_string(i), contact, 0);
+            hashed.emplace(id, client);
+            dense.insert_or_assign(id, client);
+            builder.insert_or_assign(id, client);
+        }
+        const PersistentIdMap<Client> persistent = builder.build();
+
+        std::vector<int> ids(lookups);
+        for(int& id : ids) id = 1 + static_cast<int>(random() % count);
+
+        const std::string size = std::to_string(count);
+        measure_lookup("unordered_map " + size, ids, [&](int id) -> const Client& { return hashed.at(id); });
+        measure_lookup("IdMap " + size, ids, [&](int id) -> const Client& { return *dense.find(id); });
+        measure_lookup("PersistentIdMap " + size, ids, [&](int id) -> const Client& { return *persistent.find(id); });
+        measure_scan("unordered_map " + size, hashed, count, [](const auto& entry) -> const Client& { return entry.second; });
+        measure_scan("IdMap " + size, dense, count, [](const Client& client) -> const Client& { return client; });
+        measure_scan("PersistentIdMap " + size, persistent, count, [](const Client& client) -> const Client& { return client; });
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+// Задержка интерактивных запросов (чтение и изменение одного места, как из
+// интерфейса) во время массовой записи броней порциями по транзакции:
+// без фоновой записи, при записи из отдельного потока через общее соединение
+// и при записи задачами run_async на соединении фонового потока.
+//   interactive_latency [броней]
+#include "bench.h"
+#include "../include/core/DatabaseManager.h"
+#include "../include/core/SchemaMigrator.h"
+#include <atomic>
+#include <future>
+#include <thread>
+
+namespace {
+
+constexpr int seats = 60;
+constexpr size_t chunk = 20000;
+constexpr auto idle_duration = std::chrono::seconds(1);
+
+enum class Bulk { None, SharedConnection, WriterThread };
+
+void insert_chunk(DatabaseManager& db, size_t first) {
+    db.transaction([&] {
+        for(size_t i = first; i < first + chunk; ++i) {
+            db.execute("INSERT INTO reservations (client_id, seat_id, start_time, end_time, status, total_cost) "
+                       "VALUES (1, ?, ?, ?, 2, 100.0)",
+                       {static_cast<int>(1 + i % seats), static_cast<long long>(i) * 3600,
+                        static_cast<long long>(i) * 3600 + 3600});
+        }
+    });
+}
+
+void report_latency(const std::string& label, const std::vector<double>& samples) {
+    bench::report(label + " p50", bench::percentile(samples, 0.5) * 1e3, "ms");
+    bench::report(label + " p99", bench::percentile(samples, 0.99) * 1e3, "ms");
+    bench::report(label + " max", bench::percentile(samples, 1.0) * 1e3, "ms");
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    const size_t rows = std::max(bench::size_arg(argc, argv, 400000) / chunk, size_t(1)) * chunk;
+    auto& db = DatabaseManager::instance();
+    db.connect(bench::temp_db("interactive_latency"));
+    SchemaMigrator(db).migrate();
+    db.transaction([&] {
+        db.execute("INSERT INTO clients (name, contact, reg_date) VALUES ('Клиент', '+70000000000', 0)");
+        for(int seat = 1; seat <= seats; ++seat) {
+            db.execute("INSERT INTO seats (type, status, hardware_spec) VALUES (0, 0, '')");
+        }
+    });
+
+    size_t next_row = 0;
+    for(Bulk bulk : {Bulk::None, Bulk::SharedConnection, Bulk::WriterThread}) {
+        std::atomic<bool> done{bulk == Bulk::None};
+        std::thread background;
+        std::vector<std::future<void>> tasks;
+        const auto started = bench::Clock::now();
+        const size_t first = next_row;
+        if(bulk == Bulk::SharedConnection) {
+            background = std::thread([&db, &done, first, rows] {
+                for(size_t row = first; row < first + rows; row += chunk) insert_chunk(db, row);
+                done = true;
+            });
+        } else if(bulk == Bulk::WriterThread) {
+            for(size_t row = first; row < first + rows; row += chunk) {
+                tasks.push_back(db.run_async([&db, row] { insert_chunk(db, row); }));
+            }
+            tasks.push_back(db.run_async([&done] { done = true; }));
+        }
+        if(bulk != Bulk::None) next_row += rows;
+
+        std::vector<double> reads;
+        std::vector<double> writes;
+        for(int i = 0; bulk == Bulk::None ? bench::Clock::now() - started < idle_duration : !done; ++i) {
+            const int seat = 1 + i % seats;
+            auto start = bench::Clock::now();
+            db.fetch_all("SELECT status FROM seats WHERE id = ?", {seat});
+            reads.push_back(bench::seconds_since(start));
+            start = bench::Clock::now();
+            db.execute("UPDATE seats SET status = ? WHERE id = ?", {i % 2, seat});
+            writes.push_back(bench::seconds_since(start));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if(background.joinable()) background.join();
+        for(auto& task : tasks) task.get();
+        const double elapsed = bench::seconds_since(started);
+
+        const std::string label = bulk == Bulk::None ? "idle"
+                                : bulk == Bulk::SharedConnection ? "bulk via shared connection"
+                                : "bulk via run_async";
+        report_latency(label + ", read", reads);
+        report_latency(label + ", write", writes);
+        if(bulk != Bulk::None) bench::report(label + ", bulk rows", rows / elapsed, "/s");
+    }
+    db.disconnect();
+    return 0;
+}
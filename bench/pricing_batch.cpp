@@ -0,0 +1,65 @@
+// Пакетный расчёт цен: price() по одной брони, скалярный пакет и векторное
+// ядро на N бронях (по умолчанию 2M) со скидками и праздниками.
+//   pricing_batch [броней]
+#include "bench.h"
+#include "../include/core/PricingEngine.h"
+#include <random>
+
+int main(int argc, char* argv[]) {
+    const size_t count = bench::size_arg(argc, argv, 2000000);
+    constexpr time_t day = 86400;
+    const time_t base = 1791763200 - 300 * day;
+
+    PricingEngine engine;
+    int id = 1;
+    for(int type = 0; type < static_cast<int>(PricingEngine::seat_type_count); ++type) {
+        Tariff peak(id++, "Пик", 120 + type * 37.3, Tariff::Period::Peak);
+        peak.add_discount(13.7, base + type * 5000, base + type * 5000 + 3 * day);
+        engine.set_tariff(static_cast<Seat::Type>(type), peak);
+        engine.set_tariff(static_cast<Seat::Type>(type), Tariff(id++, "День", 77.7 + type, Tariff::Period::OffPeak));
+        engine.set_tariff(static_cast<Seat::Type>(type), Tariff(id++, "Праздник", 333.3, Tariff::Period::Holiday));
+    }
+    engine.add_holiday(base + 10 * day, base + 11 * day);
+    auto started = bench::Clock::now();
+    engine.compile(base, base + 700 * day);
+    bench::report("compile 700 days (" + std::to_string(engine.breakpoints().size()) + " points)",
+                  bench::seconds_since(started) * 1e3, "ms");
+
+    std::mt19937_64 random(5);
+    PricingEngine::BatchColumns batch;
+    batch.start.reserve(count);
+    batch.end.reserve(count);
+    batch.seat_type.reserve(count);
+    for(size_t i = 0; i < count; ++i) {
+        const time_t start = base + static_cast<time_t>(random() % (690 * day));
+        batch.start.push_back(start);
+        batch.end.push_back(start + 1 + static_cast<time_t>(random() % day));
+        batch.seat_type.push_back(static_cast<int32_t>(random() % PricingEngine::seat_type_count));
+    }
+
+    double checksum = 0.0;
+    started = bench::Clock::now();
+    for(size_t i = 0; i < count; ++i) {
+        checksum += engine.price(static_cast<Seat::Type>(batch.seat_type[i]), batch.start[i], batch.end[i]);
+    }
+    const double single = bench::seconds_since(started);
+
+    std::vector<double> scalar(count);
+    started = bench::Clock::now();
+    engine.price_batch_scalar(batch, scalar.data());
+    const double scalar_seconds = bench::seconds_since(started);
+
+    started = bench::Clock::now();
+    const auto prices = engine.price_batch(batch);
+    const double batch_seconds = bench::seconds_since(started);
+
+    size_t mismatches = 0;
+    for(size_t i = 0; i < count; ++i) mismatches += prices[i] != scalar[i];
+
+    bench::report("price() one by one", count / single / 1e6, "M/s");
+    bench::report("price_batch_scalar", count / scalar_seconds / 1e6, "M/s");
+    bench::report(std::string("price_batch (") + (PricingEngine::simd_available() ? "avx2" : "scalar") + ")",
+                  count / batch_seconds / 1e6, "M/s");
+    std::printf("checksum %.2f, mismatches %zu\n", checksum, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
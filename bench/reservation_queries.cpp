@@ -0,0 +1,124 @@
+// Выборки броней: ReservationStore в памяти против SQL-запросов прежнего
+// find_reservations на N бронях (по умолчанию 500k).
+//   reservation_queries [броней]
+#include "bench.h"
+#include "../include/core/DatabaseManager.h"
+#include "../include/core/ReservationStore.h"
+#include "../include/core/SchemaMigrator.h"
+#include <random>
+
+namespace {
+
+constexpr int seats = 60;
+constexpr int clients = 1000;
+constexpr int queries = 300;
+constexpr time_t hour = 3600;
+constexpr time_t base = 1767225600;
+
+Reservation from_row(const DatabaseManager::Row& row) {
+    return Reservation(row.get_int(0), row.get_int(1), row.get_int(2),
+                       static_cast<time_t>(row.get_int64(3)), static_cast<time_t>(row.get_int64(4)),
+                       static_cast<Reservation::Status>(row.get_int(5)), row.get_double(6));
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    const size_t count = bench::size_arg(argc, argv, 500000);
+    auto& db = DatabaseManager::instance();
+    db.connect(bench::temp_db("reservation_queries"));
+    SchemaMigrator(db).migrate();
+
+    std::mt19937 random(9);
+    db.transaction([&] {
+        for(int client = 1; client <= clients; ++client) {
+            db.execute("INSERT INTO clients (name, contact, reg_date) VALUES (?, ?, 0)",
+                       {"Клиент " + std::to_string(client), "+7" + std::to_string(9000000000LL + client)});
+        }
+        for(int seat = 1; seat <= seats; ++seat) {
+            db.execute("INSERT INTO seats (type, status, hardware_spec) VALUES (0, 0, '')");
+        }
+        for(size_t i = 0; i < count; ++i) {
+            const time_t start = base + static_cast<time_t>(i / seats) * 2 * hour;
+            db.execute("INSERT INTO reservations (client_id, seat_id, start_time, end_time, status, total_cost) "
+                       "VALUES (?, ?, ?, ?, ?, ?)",
+                       {1 + static_cast<int>(random() % clients), 1 + static_cast<int>(i % seats),
+                        start, start + hour, static_cast<int>(random() % 4), 120.0});
+        }
+    });
+
+    auto started = bench::Clock::now();
+    ReservationStore store;
+    store.reserve(count);
+    db.reader().for_each_row(
+        "SELECT id, client_id, seat_id, start_time, end_time, status, total_cost FROM reservations", {},
+        [&store](const DatabaseManager::Row& row) { store.upsert(from_row(row)); });
+    bench::report("load store (" + std::to_string(store.size()) + " reservations)",
+                  bench::seconds_since(started) * 1e3, "ms");
+
+    const auto sql = [&](const std::string& where, const std::vector<DatabaseManager::Value>& params) {
+        std::vector<Reservation> result;
+        db.for_each_row("SELECT id, client_id, seat_id, start_time, end_time, status, total_cost "
+                        "FROM reservations WHERE " + where, params,
+                        [&result](const DatabaseManager::Row& row) { result.push_back(from_row(row)); });
+        return result;
+    };
+    const auto memory = [&](int client_id, int seat_id, Reservation::Status status) {
+        std::vector<Reservation> result;
+        store.for_each(client_id, seat_id, status,
+                       [&result](const Reservation& r) { result.push_back(r); });
+        return result;
+    };
+
+    struct Case {
+        std::string label;
+        int client_id;
+        int seat_id;
+        Reservation::Status status;
+    };
+    const std::vector<Case> cases = {
+        {"by client", 0, -1, Reservation::Status::ANY},
+        {"by seat and status", -1, 0, Reservation::Status::Pending},
+    };
+    size_t mismatches = 0;
+    for(const auto& c : cases) {
+        std::vector<double> sql_latency;
+        std::vector<double> memory_latency;
+        for(int q = 0; q < queries; ++q) {
+            const int client_id = c.client_id < 0 ? -1 : 1 + static_cast<int>(random() % clients);
+            const int seat_id = c.seat_id < 0 ? -1 : 1 + static_cast<int>(random() % seats);
+            started = bench::Clock::now();
+            const auto expected = client_id > 0
+                ? sql("client_id = ?", {client_id})
+                : sql("seat_id = ? AND status = ?", {seat_id, static_cast<int>(c.status)});
+            sql_latency.push_back(bench::seconds_since(started) * 1e6);
+            started = bench::Clock::now();
+            const auto found = memory(client_id, seat_id, c.status);
+            memory_latency.push_back(bench::seconds_since(started) * 1e6);
+            mismatches += found.size() != expected.size();
+        }
+        bench::report("SQL " + c.label + " p50", bench::percentile(sql_latency, 0.5), "us");
+        bench::report("store " + c.label + " p50", bench::percentile(memory_latency, 0.5), "us");
+    }
+
+    // Одна бронь по id: load_reservation
+    std::vector<double> sql_latency;
+    std::vector<double> memory_latency;
+    for(int q = 0; q < queries; ++q) {
+        const int id = 1 + static_cast<int>(random() % count);
+        started = bench::Clock::now();
+        const auto expected = sql("id = ?", {id});
+        sql_latency.push_back(bench::seconds_since(started) * 1e6);
+        started = bench::Clock::now();
+        const Reservation* found = store.find(id);
+        memory_latency.push_back(bench::seconds_since(started) * 1e6);
+        mismatches += !found || expected.size() != 1 || found->seat_id() != expected[0].seat_id();
+    }
+    bench::report("SQL by id p50", bench::percentile(sql_latency, 0.5), "us");
+    bench::report("store by id p50", bench::percentile(memory_latency, 0.5), "us");
+
+    db.release_reader();
+    db.disconnect();
+    std::printf("mismatches %zu\n", mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
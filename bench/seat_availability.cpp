@@ -0,0 +1,101 @@
+// Проверка свободного места: SeatSchedule в памяти против запроса COUNT(*)
+// к reservations на N бронях (по умолчанию 1M).
+//   seat_availability [броней]
+#include "bench.h"
+#include "../include/core/DatabaseManager.h"
+#include "../include/core/SchemaMigrator.h"
+#include "../include/core/SeatSchedule.h"
+#include <random>
+
+namespace {
+
+constexpr int seats = 200;
+constexpr int queries = 20000;
+constexpr time_t hour = 3600;
+constexpr time_t base = 1767225600;
+
+}
+
+int main(int argc, char* argv[]) {
+    const size_t count = bench::size_arg(argc, argv, 1000000);
+    auto& db = DatabaseManager::instance();
+    db.connect(bench::temp_db("seat_availability"));
+    SchemaMigrator(db).migrate();
+
+    // Брони идут подряд по каждому месту с паузами; половина уже завершена
+    std::mt19937 random(4);
+    std::vector<time_t> cursor(seats + 1, base);
+    SeatSchedule schedule;
+    auto started = bench::Clock::now();
+    db.transaction([&] {
+        db.execute("INSERT INTO clients (name, contact, reg_date) VALUES ('Клиент', '+70000000000', 0)");
+        for(int seat = 1; seat <= seats; ++seat) {
+            db.execute("INSERT INTO seats (type, status, hardware_spec) VALUES (0, 0, '')");
+        }
+        for(size_t i = 0; i < count; ++i) {
+            const int seat = 1 + static_cast<int>(i % seats);
+            const time_t start = cursor[seat] + static_cast<time_t>(random() % 3) * hour;
+            const time_t end = start + (1 + static_cast<time_t>(random() % 3)) * hour;
+            cursor[seat] = end;
+            const int status = static_cast<int>(random() % 4);
+            db.execute("INSERT INTO reservations (client_id, seat_id, start_time, end_time, status, total_cost) "
+                       "VALUES (?, ?, ?, ?, ?, ?)",
+                       {1, seat, start, end, status, 100.0});
+            if(status <= 1) schedule.add(seat, static_cast<int>(i + 1), start, end);
+        }
+    });
+    bench::report("load " + std::to_string(count) + " reservations", bench::seconds_since(started), "s");
+
+    struct Query {
+        int seat;
+        time_t start;
+        time_t end;
+    };
+    std::vector<Query> probes;
+    const time_t span = cursor[1] - base;
+    for(int q = 0; q < queries; ++q) {
+        const time_t start = base + static_cast<time_t>(random() % span);
+        probes.push_back({1 + static_cast<int>(random() % seats), start,
+                          start + (1 + static_cast<time_t>(random() % 4)) * hour});
+    }
+
+    // Прежний запрос: BETWEEN по началу и концу
+    long between_free = 0;
+    started = bench::Clock::now();
+    for(const auto& q : probes) {
+        between_free += db.fetch_all(
+            "SELECT COUNT(*) FROM reservations WHERE seat_id = ? "
+            "AND ((start_time BETWEEN ? AND ?) OR (end_time BETWEEN ? AND ?)) AND status IN (0, 1)",
+            {q.seat, q.start, q.end, q.start, q.end}).at(0).get_int(0) == 0;
+    }
+    const double between = bench::seconds_since(started);
+
+    // Правильное пересечение полуоткрытых интервалов в SQL
+    std::vector<bool> expected;
+    started = bench::Clock::now();
+    for(const auto& q : probes) {
+        expected.push_back(db.fetch_all(
+            "SELECT COUNT(*) FROM reservations WHERE seat_id = ? "
+            "AND start_time < ? AND end_time > ? AND status IN (0, 1)",
+            {q.seat, q.end, q.start}).at(0).get_int(0) == 0);
+    }
+    const double overlap = bench::seconds_since(started);
+
+    size_t mismatches = 0;
+    long schedule_free = 0;
+    started = bench::Clock::now();
+    for(size_t i = 0; i < probes.size(); ++i) {
+        const bool free = schedule.is_free(probes[i].seat, probes[i].start, probes[i].end);
+        schedule_free += free;
+        mismatches += free != expected[i];
+    }
+    const double memory = bench::seconds_since(started);
+    db.disconnect();
+
+    bench::report("SQL BETWEEN (old)", between / queries * 1e6, "us/check");
+    bench::report("SQL overlap", overlap / queries * 1e6, "us/check");
+    bench::report("SeatSchedule::is_free", memory / queries * 1e6, "us/check");
+    std::printf("free: BETWEEN %ld, schedule %ld of %d; mismatches %zu\n",
+                between_free, schedule_free, queries, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+// Продажи с нескольких касс: ClubSystem::sell_product при 1, 2, 4, ...
+// терминалах (по умолчанию до 8) с групповой фиксацией, как в main.
+// Принятые продажи в секунду, задержка вызова и время, за которое журнал
+// дописывает принятое в БД.
+//   sell_throughput [терминалов]
+#include "bench.h"
+#include "../include/core/ClubSystem.h"
+#include "../include/core/DatabaseManager.h"
+#include <atomic>
+#include <thread>
+
+namespace {
+
+constexpr int products = 20;
+constexpr int stock = 100000000;
+constexpr auto duration = std::chrono::seconds(1);
+
+}
+
+int main(int argc, char* argv[]) {
+    const size_t max_terminals = bench::size_arg(argc, argv, 8);
+    const std::string path = bench::temp_db("sell_throughput");
+    ClubSystem system;
+    system.initialize(path);
+    auto& db = DatabaseManager::instance();
+    db.set_group_commit({true, 64, std::chrono::milliseconds(5)});
+    for(int i = 0; i < products; ++i) {
+        system.add_product(Product(0, "Товар " + std::to_string(i), Product::Category::Drink, 1.5, stock));
+    }
+    std::vector<int> ids;
+    for(const auto& product : system.get_products()) ids.push_back(product.id());
+
+    int64_t sold_total = 0;
+    for(size_t terminals = 1; terminals <= max_terminals; terminals *= 2) {
+        std::atomic<bool> stop{false};
+        std::atomic<int64_t> sold{0};
+        std::vector<std::vector<double>> latency(terminals);
+        std::vector<std::thread> threads;
+        const auto started = bench::Clock::now();
+        for(size_t t = 0; t < terminals; ++t) {
+            threads.emplace_back([&, t] {
+                int64_t local = 0;
+                for(size_t i = t; !stop; i += terminals) {
+                    const auto call = bench::Clock::now();
+                    if(system.sell_product(ids[i % ids.size()], 1)) ++local;
+                    // Каждый 16-й вызов: сам замер не должен тормозить кассу
+                    if(i % 16 == t % 16) latency[t].push_back(bench::seconds_since(call) * 1e6);
+                }
+                sold += local;
+            });
+        }
+        std::this_thread::sleep_for(duration);
+        stop = true;
+        for(auto& thread : threads) thread.join();
+        const double selling = bench::seconds_since(started);
+        while(system.sales().pending() != 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        const double persisted = bench::seconds_since(started);
+        sold_total += sold;
+
+        std::vector<double> samples;
+        for(const auto& part : latency) samples.insert(samples.end(), part.begin(), part.end());
+        const std::string label = "terminals=" + std::to_string(terminals);
+        bench::report(label + " sales", sold / selling, "/s");
+        bench::report(label + " sell p50", bench::percentile(samples, 0.5), "us");
+        bench::report(label + " sell p99", bench::percentile(samples, 0.99), "us");
+        bench::report(label + " written to db", sold / persisted, "/s");
+    }
+
+    // Всё принятое записано: строки sales и списание в products сходятся
+    const int64_t in_db = db.fetch_all("SELECT COALESCE(SUM(quantity), 0) FROM sales").at(0).get_int64(0);
+    const int64_t stock_left = db.fetch_all("SELECT SUM(stock) FROM products").at(0).get_int64(0);
+    system.shutdown();
+    if(in_db != sold_total || stock_left != int64_t(products) * stock - sold_total) {
+        std::printf("mismatch: sold %lld, in db %lld\n", static_cast<long long>(sold_total),
+                    static_cast<long long>(in_db));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+// Время до первого экрана (карта мест) без снимка: последовательная загрузка
+// против параллельной, где клиенты, товары и брони догружаются в фоне, на
+// N клиентах (по умолчанию 200k) и 2.5N бронях.
+//   startup_first_screen [клиентов]
+#include "bench.h"
+#include "../include/core/ClubSystem.h"
+#include "../include/core/DatabaseManager.h"
+#include <cstdio>
+#include <sstream>
+
+namespace {
+
+constexpr int runs = 5;
+
+}
+
+int main(int argc, char* argv[]) {
+    const size_t clients = bench::size_arg(argc, argv, 200000);
+    const size_t reservations = clients * 5 / 2;
+    const std::string path = bench::temp_db("startup_first_screen");
+    {
+        ClubSystem system;
+        system.initialize(path);
+        std::stringstream csv;
+        csv << "name,contact\n";
+        for(size_t i = 0; i < clients; ++i) {
+            char contact[16];
+            std::snprintf(contact, sizeof(contact), "+7%010zu", i);
+            csv << "Клиент " << i << "," << contact << "\n";
+        }
+        system.import_clients(csv);
+
+        // Завершённые брони прошлых дней: в расписание не попадают, но
+        // читаются в хранилище при старте
+        auto& db = DatabaseManager::instance();
+        db.transaction([&] {
+            for(size_t i = 0; i < reservations; ++i) {
+                const long long start = 1700000000LL + static_cast<long long>(i) * 1800;
+                db.execute("INSERT INTO reservations (client_id, seat_id, start_time, end_time, status, total_cost) "
+                           "VALUES (?, ?, ?, ?, 2, 150.0)",
+                           {static_cast<int>(1 + i % clients), static_cast<int>(1 + i % 60),
+                            start, start + 3600});
+            }
+        });
+        system.shutdown();
+    }
+
+    for(auto mode : {ClubSystem::LoadMode::Sequential, ClubSystem::LoadMode::Parallel}) {
+        const std::string label = mode == ClubSystem::LoadMode::Parallel ? "parallel" : "sequential";
+        std::vector<double> first_screen;
+        std::vector<double> first_client;
+        std::vector<double> all_clients;
+        std::vector<double> all_data;
+        for(int run = 0; run < runs; ++run) {
+            std::remove((path + ".snap").c_str());
+            ClubSystem system;
+            const auto started = bench::Clock::now();
+            system.initialize(path, mode);
+            if(system.seats()->size() != 60) return 1;
+            first_screen.push_back(bench::seconds_since(started) * 1e3);
+            // Клиент, открытый сразу после старта, подгружается одной строкой
+            if(system.get_client(static_cast<int>(clients)).id() != static_cast<int>(clients)) return 1;
+            first_client.push_back(bench::seconds_since(started) * 1e3);
+            system.wait_for_clients();
+            all_clients.push_back(bench::seconds_since(started) * 1e3);
+            system.wait_for_data();
+            all_data.push_back(bench::seconds_since(started) * 1e3);
+            system.shutdown();
+        }
+        bench::report(label + ": seat map ready p50", bench::percentile(first_screen, 0.5), "ms");
+        bench::report(label + ": one client ready p50", bench::percentile(first_client, 0.5), "ms");
+        bench::report(label + ": all clients ready p50", bench::percentile(all_clients, 0.5), "ms");
+        bench::report(label + ": reservations ready p50", bench::percentile(all_data, 0.5), "ms");
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Запуск ClubSystem: загрузка из бинарного снимка против SQL-загрузчиков
+// на N клиентах (по умолчанию 200k). Отдельно - только чтение таблиц, без
+// построения индексов поиска, которое нужно обоим путям.
+//   startup_snapshot [клиентов]
+#include "bench.h"
+#include "../include/core/ClubSystem.h"
+#include "../include/core/DatabaseManager.h"
+#include "../include/core/StateSnapshot.h"
+#include <sstream>
+
+namespace {
+
+constexpr int runs = 5;
+
+}
+
+int main(int argc, char* argv[]) {
+    const size_t clients = bench::size_arg(argc, argv, 200000);
+    const std::string path = bench::temp_db("startup_snapshot");
+    {
+        ClubSystem system;
+        system.initialize(path);
+        std::stringstream csv;
+        csv << "name,contact\n";
+        for(size_t i = 0; i < clients; ++i) {
+            char contact[16];
+            std::snprintf(contact, sizeof(contact), "+7%010zu", i);
+            csv << "Клиент " << i << "," << contact << "\n";
+        }
+        auto started = bench::Clock::now();
+        const size_t imported = system.import_clients(csv).imported;
+        bench::report("import " + std::to_string(imported) + " clients", bench::seconds_since(started), "s");
+        for(int i = 0; i < 50; ++i) {
+            system.add_product(Product(0, "Товар " + std::to_string(i), Product::Category::Drink, 1.5, 100));
+        }
+        system.shutdown();
+    }
+
+    for(bool snapshot : {false, true}) {
+        std::vector<double> times;
+        size_t loaded = 0;
+        for(int run = 0; run < runs; ++run) {
+            if(!snapshot) std::remove((path + ".snap").c_str());
+            ClubSystem system;
+            const auto started = bench::Clock::now();
+            system.initialize(path);
+            times.push_back(bench::seconds_since(started) * 1e3);
+            loaded = system.clients()->size();
+            system.shutdown();
+        }
+        const std::string label = snapshot ? "initialize from snapshot" : "initialize from SQL";
+        bench::report(label + " p50", bench::percentile(times, 0.5), "ms");
+        bench::report(label + " clients loaded", static_cast<double>(loaded), "");
+    }
+
+    // Только чтение: разбор снимка против строк SELECT в карту клиентов
+    auto& db = DatabaseManager::instance();
+    db.connect(path);
+    const int64_t generation = db.fetch_all("SELECT value FROM meta WHERE key = 'generation'").at(0).get_int64(0);
+    std::vector<double> sql_times;
+    std::vector<double> snapshot_times;
+    size_t read_clients = 0;
+    for(int run = 0; run < runs; ++run) {
+        auto started = bench::Clock::now();
+        PersistentIdMap<Client>::Builder builder;
+        db.reader().for_each_row("SELECT id, name, contact, reg_date FROM clients", {},
+            [&builder](const DatabaseManager::Row& row) {
+                builder.insert_or_assign(row.get_int(0), Client(
+                    Client::trusted, row.get_int(0), std::string(row.get_text(1)),
+                    std::string(row.get_text(2)), static_cast<time_t>(row.get_int64(3))));
+            });
+        const auto from_sql = builder.build();
+        sql_times.push_back(bench::seconds_since(started) * 1e3);
+
+        started = bench::Clock::now();
+        const auto contents = StateSnapshot::read(path + ".snap", generation);
+        snapshot_times.push_back(bench::seconds_since(started) * 1e3);
+        read_clients = contents ? contents->clients.size() : 0;
+        if(from_sql.size() != read_clients) return 1;
+    }
+    db.release_reader();
+    db.disconnect();
+    bench::report("read clients from SQL p50", bench::percentile(sql_times, 0.5), "ms");
+    bench::report("read snapshot p50", bench::percentile(snapshot_times, 0.5), "ms");
+    return read_clients == clients ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+// Подстрочный поиск клиентов: задержка TrigramIndex::search на N клиентах
+// (по умолчанию 500k) для запросов из 1, 2, 3 и 6 символов против цели
+// меньше миллисекунды, и прежний перебор свёрнутых текстов для коротких
+// запросов.
+//   trigram_search [клиентов]
+#include "bench.h"
+#include "../include/core/TrigramIndex.h"
+#include "../include/core/Utf8.h"
+#include <random>
+
+namespace {
+
+constexpr double target_ms = 1.0;
+
+}
+
+int main(int argc, char* argv[]) {
+    const size_t clients = bench::size_arg(argc, argv, 500000);
+    const char* const first_names[] = {"Иван", "Пётр", "Анна", "Мария", "Олег",
+                                       "Денис", "Сергей", "Ольга", "Алексей", "Елена"};
+    const std::string letters = "абвгдежзиклмнопрстуфхцчшэюя";
+    std::mt19937 random(1);
+
+    // Имя, фамилия из случайных 6-9 букв и телефон
+    std::vector<std::string> names;
+    std::vector<std::string> phones;
+    names.reserve(clients);
+    phones.reserve(clients);
+    for(size_t i = 0; i < clients; ++i) {
+        std::string name = first_names[random() % 10];
+        name += ' ';
+        for(size_t n = 6 + random() % 4; n > 0; --n) {
+            name.append(letters, 2 * (random() % (letters.size() / 2)), 2);
+        }
+        names.push_back(std::move(name));
+        phones.push_back("+7" + std::to_string(9000000000ULL + i));
+    }
+
+    auto started = bench::Clock::now();
+    TrigramIndex index;
+    index.reserve(clients);
+    for(size_t i = 0; i < clients; ++i) index.add(static_cast<int>(i), {names[i], phones[i]});
+    bench::report("build index (" + std::to_string(clients) + " clients)", bench::seconds_since(started), "s");
+
+    // Прежний путь для запросов короче трёх символов - перебор всех текстов
+    std::vector<std::string> folded;
+    folded.reserve(clients);
+    for(size_t i = 0; i < clients; ++i) folded.push_back(Utf8::fold(names[i]) + '\x1f' + phones[i]);
+
+    bool met = true;
+    for(size_t length : {1, 2, 3, 6}) {
+        // Подстроки фамилий случайных клиентов
+        std::vector<std::string> queries;
+        for(int q = 0; q < 200; ++q) {
+            const std::u32string name = Utf8::decode(names[random() % clients]);
+            const size_t surname = name.find(U' ') + 1;
+            const size_t at = surname + random() % (name.size() - surname - length + 1);
+            std::string query;
+            for(char32_t c : name.substr(at, length)) Utf8::append(query, c);
+            queries.push_back(std::move(query));
+        }
+
+        std::vector<double> latency;
+        size_t found = 0;
+        for(const auto& query : queries) {
+            started = bench::Clock::now();
+            found += index.search(query).size();
+            latency.push_back(bench::seconds_since(started) * 1e3);
+        }
+        const std::string label = std::to_string(length) + " chars";
+        const double p99 = bench::percentile(latency, 0.99);
+        bench::report(label + " p50", bench::percentile(latency, 0.5), "ms");
+        bench::report(label + " p99", p99, "ms");
+        bench::report(label + " matches per query", static_cast<double>(found) / queries.size(), "");
+        met = met && p99 < target_ms;
+
+        if(length < 3) {
+            latency.clear();
+            for(size_t q = 0; q < 20; ++q) {
+                const std::string needle = Utf8::fold(queries[q]);
+                started = bench::Clock::now();
+                std::vector<int> result;
+                for(size_t i = 0; i < folded.size(); ++i) {
+                    if(folded[i].find(needle) != std::string::npos) result.push_back(static_cast<int>(i));
+                }
+                latency.push_back(bench::seconds_since(started) * 1e3);
+            }
+            bench::report(label + " linear scan p50", bench::percentile(latency, 0.5), "ms");
+        }
+    }
+    std::printf("target p99 < %.0f ms at %zu clients: %s\n", target_ms, clients, met ? "met" : "MISSED");
+    return 0;
+}
@@ -0,0 +1,81 @@
+// Чтение при непрерывной записи: запросы по броням места через общее
+// соединение и через читающие соединения WAL при 1..N читателях (по
+// умолчанию до 4), пока пишущий поток добавляет брони.
+//   wal_readers [читателей]
+#include "bench.h"
+#include "../include/core/DatabaseManager.h"
+#include "../include/core/SchemaMigrator.h"
+#include <atomic>
+#include <thread>
+
+namespace {
+
+constexpr int seats = 60;
+constexpr auto duration = std::chrono::seconds(1);
+const char* const query =
+    "SELECT COUNT(*), SUM(total_cost) FROM reservations WHERE seat_id = ? AND status IN (0, 1)";
+
+}
+
+int main(int argc, char* argv[]) {
+    const size_t max_readers = bench::size_arg(argc, argv, 4);
+    auto& db = DatabaseManager::instance();
+    db.connect(bench::temp_db("wal_readers"));
+    SchemaMigrator(db).migrate();
+
+    std::atomic<int> next_start{0};
+    const auto insert = [&] {
+        const int n = next_start++;
+        db.execute("INSERT INTO reservations (client_id, seat_id, start_time, end_time, status, total_cost) "
+                   "VALUES (1, ?, ?, ?, ?, 100.0)",
+                   {1 + n % seats, n * 3600LL, n * 3600LL + 3600, n % 4});
+    };
+    db.transaction([&] {
+        db.execute("INSERT INTO clients (name, contact, reg_date) VALUES ('Клиент', '+70000000000', 0)");
+        for(int seat = 1; seat <= seats; ++seat) {
+            db.execute("INSERT INTO seats (type, status, hardware_spec) VALUES (0, 0, '')");
+        }
+        for(int i = 0; i < 100000; ++i) insert();
+    });
+
+    for(bool own_connection : {false, true}) {
+        for(size_t readers = 1; readers <= max_readers; readers *= 2) {
+            std::atomic<bool> stop{false};
+            std::atomic<long> reads{0};
+            std::atomic<long> writes{0};
+            std::thread writer([&] {
+                while(!stop) {
+                    insert();
+                    ++writes;
+                }
+            });
+            std::vector<std::thread> threads;
+            for(size_t r = 0; r < readers; ++r) {
+                threads.emplace_back([&, r] {
+                    int seat = static_cast<int>(r);
+                    while(!stop) {
+                        const std::vector<DatabaseManager::Value> params = {1 + seat++ % seats};
+                        if(own_connection) {
+                            db.reader().fetch_all(query, params);
+                        } else {
+                            db.fetch_all(query, params);
+                        }
+                        ++reads;
+                    }
+                    if(own_connection) db.release_reader();
+                });
+            }
+            std::this_thread::sleep_for(duration);
+            stop = true;
+            writer.join();
+            for(auto& thread : threads) thread.join();
+
+            const std::string label = std::string(own_connection ? "reader()" : "shared connection") +
+                                      ", readers=" + std::to_string(readers);
+            bench::report(label + " reads", reads / std::chrono::duration<double>(duration).count(), "/s");
+            bench::report(label + " writes", writes / std::chrono::duration<double>(duration).count(), "/s");
+        }
+    }
+    db.disconnect();
+    return 0;
+}
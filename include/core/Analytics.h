@@ -0,0 +1,75 @@
+#pragma once
+
+#include "PersistentIdMap.h"
+#include "../models/Seat.h"
+#include "../models/Reservation.h"
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+class ReservationManager;
+
+// Брони в столбцах: компактные массивы вместо объектов Reservation,
+// отчёты просматривают только нужные им столбцы
+struct ReservationColumns {
+    std::vector<int32_t> id;
+    std::vector<int32_t> client_id;
+    std::vector<int32_t> seat_id;
+    std::vector<int64_t> start;
+    std::vector<int64_t> end;
+    std::vector<float> cost;
+    std::vector<uint8_t> status;
+
+    size_t size() const noexcept { return id.size(); }
+    void reserve(size_t count);
+    void push_back(const Reservation& reservation);
+};
+
+// Отчёты по загрузке мест и выручке за окно [from, to). Учитываются брони
+// во всех статусах, кроме отменённых. Столбцы делятся между потоками на
+// непересекающиеся диапазоны, у каждого потока свои счётчики; занятость
+// считается в целых секундах, поэтому результат не зависит от числа потоков.
+class Analytics {
+public:
+    static constexpr int hours_per_week = 168;
+
+    // Доля занятого времени для каждого места и часа недели
+    // (0 - понедельник 00:00 по местному времени)
+    struct Heatmap {
+        std::vector<int> seat_ids;
+        std::vector<double> occupancy;      // seat_ids.size() x hours_per_week
+
+        double at(size_t seat_index, int hour_of_week) const {
+            return occupancy[seat_index * hours_per_week + hour_of_week];
+        }
+    };
+
+    struct TypeUtilization {
+        Seat::Type type;
+        int seats = 0;
+        double occupied_hours = 0.0;
+        double utilization = 0.0;           // Доля от seats * длительность окна
+    };
+
+    // Выручка относится к суткам начала брони
+    struct DailyRevenue {
+        time_t day;                         // Местная полночь
+        int reservations = 0;
+        double revenue = 0.0;
+    };
+
+    struct Report {
+        time_t from = 0;
+        time_t to = 0;
+        size_t scanned = 0;                 // Просмотрено броней
+        double seconds = 0.0;               // Время просмотра без загрузки столбцов
+        Heatmap heatmap;
+        std::vector<TypeUtilization> by_type;
+        std::vector<DailyRevenue> revenue;
+    };
+
+    // Брони, пересекающиеся с окном
+    static ReservationColumns load(const ReservationManager& reservations, time_t from, time_t to);
+    static Report build(const ReservationColumns& columns, const PersistentIdMap<Seat>& seats,
+                        time_t from, time_t to);
+};
@@ -2,53 +2,188 @@
 
 #include "ReservationManager.h"
 #include "DatabaseManager.h"
+#include "SchemaMigrator.h"
+#include "PersistentIdMap.h"
+#include "TrigramIndex.h"
+#include "FuzzyNameIndex.h"
+#include "StateSnapshot.h"
+#include "CsvReader.h"
+#include "StockCounters.h"
+#include "SalesLedger.h"
 #include "../models/Client.h"
 #include "../models/Seat.h"
 #include "../models/Tariff.h"
 #include "../models/Product.h"
 #include <vector>
 #include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <future>
+#include <istream>
 #include <filesystem>
 #include <algorithm>
 #include <ctime>
 
 class ReservationManager;
 
+// Сущности хранятся в неизменяемых снимках. Читатели берут снимок без
+// блокировок (atomic_load), писатели под write_mutex_ копируют снимок,
+// изменяют копию и публикуют её атомарно. Полученный снимок остаётся
+// валидным, сколько бы раз его ни заменили.
 class ClubSystem {
 public:
+    using SeatMap = PersistentIdMap<Seat>;
+    using ClientMap = PersistentIdMap<Client>;
+    using ProductMap = PersistentIdMap<Product>;
+    using SeatSnapshot = std::shared_ptr<const SeatMap>;
+    using ClientSnapshot = std::shared_ptr<const ClientMap>;
+    using ProductSnapshot = std::shared_ptr<const ProductMap>;
+
+    // Sequential - все таблицы читаются до возврата из initialize.
+    // Parallel - до возврата читаются только места (первый экран). Клиенты
+    // догружаются в фоне, до окончания загрузки get_client подгружает
+    // недостающего клиента одним запросом. Товары, итоги продаж и брони
+    // догружаются в другом фоновом потоке; обращения к ним ждут загрузки.
+    enum class LoadMode { Sequential, Parallel };
+
     ClubSystem();
     ~ClubSystem();
     
-    void initialize(const std::string& db_path);
+    void initialize(const std::string& db_path, LoadMode mode = LoadMode::Sequential);
     void shutdown();
+    // Ждёт окончания фоновой загрузки клиентов (и пробрасывает её ошибку)
+    void wait_for_clients() const;
+    // То же для товаров, итогов продаж и броней
+    void wait_for_data() const;
+
+    // Записывает бинарный снимок, если данные изменились с прошлой записи.
+    // Вызывается при shutdown() и периодически из фонового потока.
+    void save_snapshot();
+    void set_snapshot_interval(std::chrono::seconds interval);
+
+    struct ImportError {
+        size_t line;
+        std::string message;
+    };
+
+    struct ImportReport {
+        size_t rows = 0;        // Записей данных в файле (без заголовка)
+        size_t imported = 0;
+        std::vector<ImportError> errors;
+        double seconds = 0.0;
+
+        double rows_per_second() const noexcept {
+            return seconds > 0.0 ? static_cast<double>(rows) / seconds : 0.0;
+        }
+    };
+
+    // Пакетный импорт из CSV. Строки проверяются параллельно порциями,
+    // вставляются многострочными INSERT в одной транзакции на порцию;
+    // отклонённые строки попадают в отчёт, остальные импортируются.
+    // Клиенты: name,contact[,reg_date]
+    ImportReport import_clients(std::istream& csv);
+    // Товары: name,category,price,stock (категория - номер или
+    // food/drink/accessory/service)
+    ImportReport import_products(std::istream& csv);
 
     Client create_client(std::string name, std::string contact);
     bool update_client(int id, const std::string& new_contact);
 
     void add_product(const Product& product);
-    bool sell_product(int product_id, int quantity = 1);
-    const std::unordered_map<int, Product>& products() const;
+    // Без блокировок между кассами: резерв остатка в памяти (CAS), запись
+    // в журнал продаж, затем списание. В БД продажа попадает порцией из
+    // журнала. client_id = 0 - продажа без клиента.
+    bool sell_product(int product_id, int quantity = 1, int client_id = 0);
+    std::future<bool> sell_product_async(int product_id, int quantity = 1, int client_id = 0);
+    // Остаток товаров в снимке - на момент загрузки или добавления,
+    // текущий остаток - product_stock() и get_products()
+    ProductSnapshot products() const;
+    int product_stock(int product_id) const noexcept;
 
     ReservationManager& reservations();
-    const std::vector<Seat>& seats() const noexcept;
-    const Client& get_client(int client_id) const;
-    const Seat& get_seat(int seat_id) const;
+    const SalesLedger& sales() const;
+    SeatSnapshot seats() const;
+    ClientSnapshot clients() const;
+    Client get_client(int client_id) const;
+    Seat get_seat(int seat_id) const;
     std::vector<Product> get_products() const;
     std::vector<Client> find_clients(const std::string& query) const;
+    // Поиск по имени с опечатками: не более max_edits правок на слово,
+    // лучшие limit клиентов по возрастанию числа правок
+    std::vector<Client> find_clients_fuzzy(const std::string& query,
+                                           int max_edits = 2,
+                                           size_t limit = 10) const;
     void update_seat_status(int seat_id, Seat::Status new_status);
+    // Выполняется в пишущем потоке БД; ошибка приходит через future
+    std::future<void> update_seat_status_async(int seat_id, Seat::Status new_status);
     void initialize_default_seats();
     void addSeat(const Seat& seat);
 
 private:
     ReservationManager* reservation_manager_;
-    std::vector<Seat> seats_;
-    std::unordered_map<int, Client> clients_;
-    std::unordered_map<int, Product> products_;
+    SeatSnapshot seats_;
+    // mutable: get_client публикует клиентов, подгруженных по промаху
+    mutable ClientSnapshot clients_;
+    ProductSnapshot products_;
+    StockCounters stock_;
+    SalesLedger sales_;
+    mutable std::mutex write_mutex_;
+
+    // Одиночные изменения ждут групповой фиксации без write_mutex_ и
+    // попадают в память после неё. Номер изменения не даёт более раннему
+    // изменению той же записи, чей билет завершился позже, затереть более
+    // позднее; снимок состояния ждёт, пока все зафиксированные изменения
+    // не попадут в память.
+    uint64_t write_sequence_ = 0;
+    size_t writes_in_flight_ = 0;
+    std::condition_variable writes_applied_cv_;
+    std::unordered_map<int, uint64_t> client_versions_;
+    std::unordered_map<int, uint64_t> seat_versions_;
+
+    std::shared_future<void> clients_loading_;
+    std::shared_future<void> data_loading_;
+    std::atomic<bool> clients_complete_{true};
+
+    TrigramIndex client_index_;
+    FuzzyNameIndex client_names_;
+    mutable std::shared_mutex client_index_mutex_;
+
+    std::string snapshot_path_;
+    int64_t snapshot_generation_ = -1;
+    std::mutex snapshot_mutex_;
+    std::chrono::seconds snapshot_interval_{300};
+    std::thread snapshot_thread_;
+    std::mutex snapshot_timer_mutex_;
+    std::condition_variable snapshot_timer_cv_;
+    bool stop_snapshots_ = false;
 
     void setup_database();
-    void load_data();
+    void load_data(LoadMode mode);
+    bool load_snapshot();
+    std::shared_ptr<const Client> fault_in_client(int client_id) const;
+    int64_t data_generation() const;
+    void start_snapshot_timer();
+    void stop_snapshot_timer();
+    void build_client_indexes(const ClientMap& clients);
+    static void index_clients(const ClientMap& clients,
+                              TrigramIndex& index, FuzzyNameIndex& names);
     void save_data();
+    uint64_t begin_write();
+    bool finish_write(std::unordered_map<int, uint64_t>& versions, int id,
+                      uint64_t sequence, bool committed);
     void load_seats();
     void load_clients();
     void load_products();
-};
\ No newline at end of file
+    void track_stock(const ProductMap& products);
+    std::vector<Product> current_products(const ProductMap& products) const;
+
+    template<typename T>
+    static void publish(std::shared_ptr<const T>& slot, std::shared_ptr<T> next) {
+        std::atomic_store(&slot, std::shared_ptr<const T>(std::move(next)));
+    }
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+// Потоковое чтение CSV (RFC 4180): поля в кавычках, удвоенные кавычки,
+// переводы строк внутри кавычек, окончания строк \n и \r\n.
+// Данные читаются порциями, чтобы не держать весь файл в памяти.
+class CsvReader {
+public:
+    struct Record {
+        size_t line;                    // Номер строки файла, с которой начинается запись
+        std::vector<std::string> fields;
+        std::string error;              // Непустая - запись повреждена, поля неполные
+    };
+
+    explicit CsvReader(std::istream& in, char delimiter = ',');
+
+    // Дописывает в out не более max_records записей; false - данные кончились
+    bool read_chunk(size_t max_records, std::vector<Record>& out);
+
+private:
+    std::istream& in_;
+    char delimiter_;
+    size_t line_ = 1;
+    bool first_ = true;
+    std::string pending_;               // Прочитанные при поиске BOM байты, не входящие в него
+
+    int get();
+    int peek();
+    void skip_bom();
+    bool read_record(Record& record);
+};
@@ -1,31 +1,266 @@
 #pragma once
 
 #include <sqlite3.h>
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <variant>
+#include <functional>
+#include <list>
+#include <deque>
+#include <unordered_map>
 #include <stdexcept>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <type_traits>
 
 class DatabaseManager {
+private:
+    struct CachedStatement {
+        std::string sql;
+        sqlite3_stmt* stmt;
+        bool in_use;
+    };
+    using StatementList = std::list<CachedStatement>;
+
+    // Владеет выданным запросом: возвращает его в кэш (reset + clear_bindings)
+    // либо финализирует, если запрос не был закэширован.
+    class Statement {
+    public:
+        Statement(sqlite3_stmt* stmt, CachedStatement* entry);
+        ~Statement();
+
+        Statement(const Statement&) = delete;
+        Statement& operator=(const Statement&) = delete;
+
+        sqlite3_stmt* get() const noexcept { return stmt_; }
+
+    private:
+        sqlite3_stmt* stmt_;
+        CachedStatement* entry_;
+    };
+
+    // LRU-кэш подготовленных запросов одного соединения
+    class StatementCache {
+    public:
+        StatementCache() = default;
+        ~StatementCache();
+
+        StatementCache(const StatementCache&) = delete;
+        StatementCache& operator=(const StatementCache&) = delete;
+
+        void attach(sqlite3* db);
+        void clear();
+        Statement acquire(const std::string& query);
+
+        void set_capacity(size_t capacity);
+        size_t hits() const noexcept { return hits_; }
+        size_t misses() const noexcept { return misses_; }
+
+    private:
+        sqlite3* db_ = nullptr;
+        StatementList lru_;
+        std::unordered_map<std::string, StatementList::iterator> index_;
+        size_t capacity_ = 32;
+        size_t hits_ = 0;
+        size_t misses_ = 0;
+
+        void evict(size_t capacity);
+    };
+
 public:
-    struct ResultRow {
-        std::vector<std::string> columns;
+    // Ошибка SQLite с расширенным кодом результата
+    class Error : public std::runtime_error {
+    public:
+        Error(const std::string& message, int code) : std::runtime_error(message), code_(code) {}
+
+        int code() const noexcept { return code_; }
+        // Запрос отклонён из-за данных строки (ограничение, триггер, тип):
+        // повтор не поможет. Остальные ошибки (занятость, ввод-вывод) временные.
+        bool row_error() const noexcept {
+            const int primary = code_ & 0xff;
+            return primary == SQLITE_CONSTRAINT || primary == SQLITE_MISMATCH ||
+                   primary == SQLITE_TOOBIG || primary == SQLITE_RANGE;
+        }
+
+    private:
+        int code_;
+    };
+
+    // Параметр запроса. Текст не копируется: строка должна жить до конца вызова.
+    class Value {
+    public:
+        enum class Type { Null, Integer, Real, Text };
+
+        Value(std::nullptr_t = nullptr) noexcept : type_(Type::Null) {}
+        Value(int v) noexcept : type_(Type::Integer), integer_(v) {}
+        Value(long v) noexcept : type_(Type::Integer), integer_(v) {}
+        Value(long long v) noexcept : type_(Type::Integer), integer_(v) {}
+        Value(double v) noexcept : type_(Type::Real), real_(v) {}
+        Value(std::string_view v) noexcept : type_(Type::Text), text_(v) {}
+        Value(const char* v) noexcept : type_(Type::Text), text_(v) {}
+        Value(const std::string& v) noexcept : type_(Type::Text), text_(v) {}
+
+        Type type() const noexcept { return type_; }
+        int64_t integer() const noexcept { return integer_; }
+        double real() const noexcept { return real_; }
+        std::string_view text() const noexcept { return text_; }
+
+    private:
+        Type type_;
+        int64_t integer_ = 0;
+        double real_ = 0.0;
+        std::string_view text_;
+    };
+
+    // Типизированное представление текущей строки запроса (без копирования)
+    class Row {
+    public:
+        explicit Row(sqlite3_stmt* stmt) noexcept : stmt_(stmt) {}
+
+        int size() const noexcept;
+        int column_type(int i) const noexcept;
+        bool is_null(int i) const noexcept;
+        int get_int(int i) const noexcept;
+        int64_t get_int64(int i) const noexcept;
+        double get_double(int i) const noexcept;
+        std::string_view get_text(int i) const noexcept;
+
+    private:
+        sqlite3_stmt* stmt_;
+    };
+
+    // Материализованная строка результата с типизированными ячейками
+    class ResultRow {
+    public:
+        explicit ResultRow(const Row& row);
+
+        int size() const noexcept;
+        bool is_null(int i) const;
+        int get_int(int i) const;
+        int64_t get_int64(int i) const;
+        double get_double(int i) const;
+        std::string_view get_text(int i) const;
+
+    private:
+        using Field = std::variant<std::monostate, int64_t, double, std::string>;
+        std::vector<Field> columns_;
+    };
+
+    // Параметры хранилища, применяемые при подключении
+    struct StorageProfile {
+        std::string journal_mode = "WAL";
+        std::string synchronous = "NORMAL";
+        int64_t mmap_size = 256LL * 1024 * 1024;
+        int cache_size = -16000;        // Отрицательное значение - размер в КиБ
+        int busy_timeout_ms = 5000;
+    };
+
+    // Соединение только для чтения, закреплённое за одним потоком.
+    // В режиме WAL читатели не блокируются пишущим соединением.
+    class ReadConnection {
+    public:
+        ~ReadConnection();
+
+        ReadConnection(const ReadConnection&) = delete;
+        ReadConnection& operator=(const ReadConnection&) = delete;
+
+        std::vector<ResultRow> fetch_all(const std::string& query,
+                                         const std::vector<Value>& params = {});
+        void for_each_row(const std::string& query,
+                          const std::vector<Value>& params,
+                          const std::function<void(const Row&)>& fn);
+
+    private:
+        friend class DatabaseManager;
+        ReadConnection(const std::string& path, const StorageProfile& profile);
+
+        sqlite3* db_ = nullptr;
+        StatementCache statements_;
     };
-    
+
+    // Групповая фиксация: одиночные изменения копятся в очереди и записываются
+    // одной транзакцией по достижении max_batch записей или через max_delay.
+    struct GroupCommitPolicy {
+        bool enabled = false;
+        size_t max_batch = 64;
+        std::chrono::milliseconds max_delay{5};
+    };
+
+    // Готов, когда изменение зафиксировано (или содержит ошибку записи)
+    using WriteTicket = std::shared_future<void>;
+
     static DatabaseManager& instance();
-    
+
     void connect(const std::string& dbPath);
+    void connect(const std::string& dbPath, const StorageProfile& profile);
     void disconnect();
     bool is_connected() const;
-    
+
     void execute(const std::string& query);
-    void execute(const std::string& query, const std::vector<std::string>& params);
-    
-    std::vector<ResultRow> fetch_all(const std::string& query, 
-                                   const std::vector<std::string>& params = {});
-    
+    void execute(const std::string& query, const std::vector<Value>& params);
+
+    std::vector<ResultRow> fetch_all(const std::string& query,
+                                   const std::vector<Value>& params = {});
+
+    // Потоковый обход результата: Row и его текст валидны только внутри fn
+    using RowVisitor = std::function<void(const Row&)>;
+    void for_each_row(const std::string& query,
+                      const std::vector<Value>& params,
+                      const RowVisitor& fn);
+
+    int64_t last_insert_id() const;
+    // INSERT и получение rowid атомарно относительно других потоков
+    int64_t insert(const std::string& query, const std::vector<Value>& params);
+
+    // Читающее соединение текущего потока (создаётся при первом обращении,
+    // закрывается release_reader или при завершении потока).
+    // Перед выдачей дописывает очередь групповой фиксации, чтобы чтение видело
+    // уже принятые изменения.
+    ReadConnection& reader();
+    void release_reader();
+    // Открытые читающие соединения
+    size_t reader_count();
+
     void begin_transaction();
     void commit_transaction();
     void rollback_transaction();
+    // Выполняет fn в своей транзакции, удерживая соединение: запросы других
+    // потоков ждут её окончания. Ошибка откатывает транзакцию и пробрасывается.
+    void transaction(const std::function<void()>& fn);
+
+    // Без групповой фиксации выполняется сразу и выбрасывает ошибку как execute
+    WriteTicket submit(const std::string& query, const std::vector<Value>& params);
+    void flush();
+    void set_group_commit(const GroupCommitPolicy& policy);
+    bool group_commit_enabled() const;
+
+    // Асинхронное выполнение: задачи ставятся в очередь и по порядку
+    // выполняются фоновым потоком, который живёт от connect до disconnect.
+    // У потока своё соединение: execute, fetch_all, insert и transaction из
+    // задачи идут через него, не занимая mutex_, поэтому запросы других
+    // потоков не ждут окончания задачи (запись ждёт только блокировку записи
+    // SQLite). Вызывающий поток не ждёт SQLite и fsync; результат или
+    // исключение задачи приходит через future.
+    template<typename Task>
+    auto run_async(Task task) -> std::future<std::invoke_result_t<Task&>>;
+    // Параметры копируются: строки не обязаны жить до выполнения
+    std::future<void> execute_async(const std::string& query, const std::vector<Value>& params = {});
+    std::future<int64_t> insert_async(const std::string& query, const std::vector<Value>& params);
+    // Дожидается выполнения всех поставленных задач
+    void wait_async();
+
+    // Кэш подготовленных запросов (LRU по тексту SQL)
+    void set_statement_cache_capacity(size_t capacity);
+    size_t statement_cache_hits() const noexcept;
+    size_t statement_cache_misses() const noexcept;
 
     DatabaseManager(const DatabaseManager&) = delete;
     DatabaseManager& operator=(const DatabaseManager&) = delete;
@@ -33,9 +268,110 @@ public:
 private:
     DatabaseManager() = default;
     ~DatabaseManager();
-    
+
+    // Параметр, владеющий своим текстом
+    using OwnedValue = std::variant<std::monostate, int64_t, double, std::string>;
+
+    // Вызов на общем соединении под mutex_. Пока такие вызовы ждут или
+    // выполняются, фоновый поток задач не начинает новую запись и не отнимает
+    // у них блокировку записи SQLite между своими транзакциями.
+    class SharedCall {
+    public:
+        explicit SharedCall(DatabaseManager& manager);
+        ~SharedCall();
+
+        SharedCall(const SharedCall&) = delete;
+        SharedCall& operator=(const SharedCall&) = delete;
+
+    private:
+        DatabaseManager& manager_;
+        std::unique_lock<std::recursive_mutex> lock_;
+    };
+
+    // Пишущее соединение текущего потока: у фонового потока задач - своё,
+    // у остальных - общее под mutex_. Перед запросом дописывает очередь
+    // групповой фиксации.
+    class Session {
+    public:
+        explicit Session(DatabaseManager& manager);
+
+        sqlite3* db() const noexcept { return db_; }
+        StatementCache& statements() const noexcept { return *statements_; }
+
+    private:
+        std::optional<SharedCall> shared_;
+        sqlite3* db_;
+        StatementCache* statements_;
+    };
+
+    struct PendingWrite {
+        std::string query;
+        std::vector<OwnedValue> params;
+        std::promise<void> done;
+        std::chrono::steady_clock::time_point queued_at;
+    };
+
     sqlite3* db_ = nullptr;
-    
+    std::string db_path_;
+    StorageProfile profile_;
+    mutable std::recursive_mutex mutex_;
+    StatementCache statements_;
+    std::atomic<int> shared_calls_{0};
+    std::mutex shared_calls_mutex_;
+    std::condition_variable shared_calls_cv_;
+
+    std::unordered_map<std::thread::id, std::unique_ptr<ReadConnection>> readers_;
+    std::mutex readers_mutex_;
+
+    GroupCommitPolicy group_commit_;
+    std::deque<PendingWrite> pending_;
+    std::atomic<size_t> pending_count_{0};
+    mutable std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::thread flusher_;
+    bool stop_flusher_ = false;
+
+    std::deque<std::function<void()>> async_tasks_;
+    std::mutex async_mutex_;
+    std::condition_variable async_cv_;
+    std::condition_variable async_idle_cv_;
+    std::thread writer_;
+    sqlite3* writer_db_ = nullptr;
+    StatementCache writer_statements_;
+    bool writer_busy_ = false;
+    bool stop_writer_ = false;
+
     void check_connection() const;
-    sqlite3_stmt* prepare_statement(const std::string& query);
-};
\ No newline at end of file
+    void run(const std::string& query, const std::vector<Value>& params);
+    static void run(sqlite3* db, StatementCache& statements,
+                    const std::string& query, const std::vector<Value>& params);
+    static sqlite3* open_writer(const std::string& path, const StorageProfile& profile);
+    void close_readers();
+
+    static sqlite3_stmt* prepare_statement(sqlite3* db, const std::string& query);
+    static void bind_params(sqlite3* db, sqlite3_stmt* stmt, const std::vector<Value>& params);
+    static void step_rows(sqlite3* db, sqlite3_stmt* stmt, const std::function<void(const Row&)>& fn);
+    static void apply_profile(sqlite3* db, const StorageProfile& profile, bool writer);
+    static std::vector<OwnedValue> own_params(const std::vector<Value>& params);
+    static std::vector<Value> borrow_params(const std::vector<OwnedValue>& params);
+
+    void flusher_loop();
+    void stop_flusher();
+    void drain_pending();
+    void write_batch(std::deque<PendingWrite>& batch);
+
+    void enqueue_async(std::function<void()> task);
+    void start_writer();
+    void stop_writer();
+    void writer_loop();
+};
+
+template<typename Task>
+auto DatabaseManager::run_async(Task task) -> std::future<std::invoke_result_t<Task&>> {
+    using Result = std::invoke_result_t<Task&>;
+    // packaged_task не копируется, а очередь хранит std::function
+    auto job = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+    auto result = job->get_future();
+    enqueue_async([job] { (*job)(); });
+    return result;
+}
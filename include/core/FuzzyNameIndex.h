@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Поиск клиентов по имени с опечатками. Различные слова имён (после
+// Utf8::fold) хранятся один раз: в префиксном дереве и в списках по биграммам.
+// Слово запроса ищется фильтром по общим биграммам с проверкой расстояния
+// кандидатов, а короткое слово, для которого фильтр ничего не отсекает, -
+// обходом дерева со строкой таблицы Левенштейна на узел. Клиент подходит,
+// если каждое слово запроса нашлось среди слов его имени: кандидатов даёт
+// самое редкое из найденных слов запроса, остальные сверяются со словами
+// кандидата.
+class FuzzyNameIndex {
+public:
+    struct Match {
+        int id;
+        int distance;   // Сумма расстояний по словам запроса
+    };
+
+    void clear();
+    void add(int id, std::string_view name);
+    void remove(int id, std::string_view name);
+
+    // Не более limit совпадений, по возрастанию расстояния
+    std::vector<Match> search(std::string_view query, int max_edits, size_t limit) const;
+
+    static int distance(std::u32string_view a, std::u32string_view b);
+    // Расстояние, если оно не больше bound, иначе bound + 1. Считается только
+    // полоса |i - j| <= bound, расчёт прекращается, когда вся строка таблицы
+    // больше bound.
+    static int distance(std::u32string_view a, std::u32string_view b, int bound);
+
+private:
+    static constexpr uint32_t none = UINT32_MAX;
+    // Столько кандидатов сверить быстрее, чем искать остальные слова запроса
+    static constexpr size_t selective_count = 4096;
+
+    // Дети узла - односвязный список: узел занимает 16 байт
+    struct Node {
+        char32_t symbol;
+        uint32_t first_child = none;
+        uint32_t next_sibling = none;
+        uint32_t term = none;       // Слово, оканчивающееся в узле
+    };
+
+    // Найденное слово: номер и расстояние до слова запроса
+    using TermMatch = std::pair<uint32_t, int>;
+
+    std::vector<Node> nodes_{Node{U'\0'}};
+    std::u32string term_text_;                          // Слова подряд
+    std::vector<uint32_t> term_start_{0};               // Границы слов в term_text_
+    std::vector<std::vector<int>> term_ids_;            // Клиенты каждого слова
+    std::vector<std::vector<uint32_t>> client_terms_;   // Слова каждого клиента, по id
+    // Биграммы слова с границами (^а, аб, ..., я$) -> номера слов по возрастанию;
+    // слово с повтором биграммы встречается в списке подряд несколько раз
+    std::unordered_map<uint64_t, std::vector<uint32_t>> bigrams_;
+    size_t max_length_ = 0;
+
+    std::u32string_view term(uint32_t index) const noexcept {
+        return std::u32string_view(term_text_).substr(term_start_[index],
+                                                      term_start_[index + 1] - term_start_[index]);
+    }
+
+    static std::vector<std::u32string> split_words(std::string_view text);
+    static std::vector<uint64_t> word_bigrams(const std::u32string& word);
+    uint32_t find_term(const std::u32string& word) const;
+    uint32_t insert_term(const std::u32string& word);
+    void collect(const std::u32string& word, int max_edits, std::vector<TermMatch>& found) const;
+    void filter(const std::u32string& word, int max_edits, int threshold,
+                std::vector<TermMatch>& found) const;
+    void walk(uint32_t node, size_t depth, const std::u32string& word, int max_edits,
+              std::vector<int>& rows, std::vector<TermMatch>& found) const;
+};
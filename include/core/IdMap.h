@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Хранилище сущностей по плотным целочисленным id (AUTOINCREMENT из SQLite).
+// slots_[id] указывает на позицию в непрерывном массиве values_ либо равен
+// npos (удалённая запись). Поиск - O(1), обход - по непрерывной памяти.
+// Удаление переносит последний элемент на место удалённого, поэтому
+// порядок обхода совпадает с порядком вставки только без удалений.
+template<typename T>
+class IdMap {
+public:
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    T* find(int id) noexcept {
+        const uint32_t slot = slot_of(id);
+        return slot == npos ? nullptr : &values_[slot];
+    }
+
+    const T* find(int id) const noexcept {
+        const uint32_t slot = slot_of(id);
+        return slot == npos ? nullptr : &values_[slot];
+    }
+
+    bool contains(int id) const noexcept {
+        return slot_of(id) != npos;
+    }
+
+    T& at(int id) {
+        T* value = find(id);
+        if(!value) throw std::out_of_range("IdMap: id not found");
+        return *value;
+    }
+
+    const T& at(int id) const {
+        const T* value = find(id);
+        if(!value) throw std::out_of_range("IdMap: id not found");
+        return *value;
+    }
+
+    T& insert_or_assign(int id, T value) {
+        if(id < 0) throw std::invalid_argument("IdMap: negative id");
+
+        const auto index = static_cast<size_t>(id);
+        if(index >= slots_.size()) {
+            slots_.resize(index + 1, npos);
+        }
+        if(slots_[index] != npos) {
+            T& existing = values_[slots_[index]];
+            existing = std::move(value);
+            return existing;
+        }
+
+        slots_[index] = static_cast<uint32_t>(values_.size());
+        values_.push_back(std::move(value));
+        ids_.push_back(id);
+        return values_.back();
+    }
+
+    bool erase(int id) {
+        const uint32_t slot = slot_of(id);
+        if(slot == npos) return false;
+
+        const uint32_t last = static_cast<uint32_t>(values_.size() - 1);
+        if(slot != last) {
+            values_[slot] = std::move(values_[last]);
+            ids_[slot] = ids_[last];
+            slots_[static_cast<size_t>(ids_[slot])] = slot;
+        }
+        values_.pop_back();
+        ids_.pop_back();
+        slots_[static_cast<size_t>(id)] = npos;
+        return true;
+    }
+
+    void reserve(size_t count) {
+        values_.reserve(count);
+        ids_.reserve(count);
+    }
+
+    void clear() noexcept {
+        slots_.clear();
+        values_.clear();
+        ids_.clear();
+    }
+
+    size_t size() const noexcept { return values_.size(); }
+    bool empty() const noexcept { return values_.empty(); }
+
+    const std::vector<T>& values() const noexcept { return values_; }
+    const std::vector<int>& ids() const noexcept { return ids_; }
+
+    iterator begin() noexcept { return values_.begin(); }
+    iterator end() noexcept { return values_.end(); }
+    const_iterator begin() const noexcept { return values_.begin(); }
+    const_iterator end() const noexcept { return values_.end(); }
+
+private:
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    std::vector<uint32_t> slots_;
+    std::vector<T> values_;
+    std::vector<int> ids_;
+
+    uint32_t slot_of(int id) const noexcept {
+        if(id < 0 || static_cast<size_t>(id) >= slots_.size()) return npos;
+        return slots_[static_cast<size_t>(id)];
+    }
+};
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+// Неизменяемые версии карты id -> значение для снимков, которые читаются
+// без блокировок. Значения лежат в отдельных shared_ptr, листья и внутренние
+// узлы - блоки по 64 указателя (дерево по разрядам id). Узлы после
+// публикации не меняются и разделяются версиями: копия карты - O(1),
+// insert_or_assign копирует только путь от корня до листа (не больше 6
+// узлов по 64 указателя) и не зависит от числа записей.
+//
+// Builder заполняет собственные узлы на месте - для загрузки и пакетных
+// изменений, где копирование пути на каждую запись было бы лишним.
+// Обход - по возрастанию id.
+template<typename T>
+class PersistentIdMap {
+    static constexpr int bits = 6;
+    static constexpr size_t fanout = size_t(1) << bits;
+    static constexpr int max_depth = 6;                 // 64^6 > INT_MAX
+
+    struct Node {
+        // Builder, создавший узел: только он может менять узел на месте
+        uint64_t owner = 0;
+        // Во внутренних узлах - дочерние Node, в листьях - T
+        std::array<std::shared_ptr<const void>, fanout> slots;
+    };
+
+public:
+    class Builder;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() = default;
+
+        reference operator*() const noexcept { return *current_; }
+        pointer operator->() const noexcept { return current_; }
+
+        const_iterator& operator++() {
+            ++path_[depth_ - 1].index;
+            settle(depth_ - 1);
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const const_iterator& other) const noexcept { return current_ == other.current_; }
+        bool operator!=(const const_iterator& other) const noexcept { return current_ != other.current_; }
+
+    private:
+        friend class PersistentIdMap;
+
+        struct Frame {
+            const Node* node;
+            size_t index;
+        };
+
+        std::array<Frame, max_depth> path_{};
+        int depth_ = 0;
+        const T* current_ = nullptr;
+
+        const_iterator(const Node* root, int depth) : depth_(depth) {
+            if(!root) return;
+            path_[0] = {root, 0};
+            settle(0);
+        }
+
+        // Спускается к первому значению, начиная с позиции path_[level]
+        void settle(int level) {
+            while(level >= 0) {
+                Frame& frame = path_[level];
+                while(frame.index < fanout && !frame.node->slots[frame.index]) ++frame.index;
+                if(frame.index == fanout) {
+                    if(--level >= 0) ++path_[level].index;
+                    continue;
+                }
+                const void* slot = frame.node->slots[frame.index].get();
+                if(level == depth_ - 1) {
+                    current_ = static_cast<const T*>(slot);
+                    return;
+                }
+                path_[++level] = {static_cast<const Node*>(slot), 0};
+            }
+            current_ = nullptr;
+        }
+    };
+
+    PersistentIdMap() = default;
+
+    const T* find(int id) const noexcept {
+        const std::shared_ptr<const void>* slot = slot_of(id);
+        return slot ? static_cast<const T*>(slot->get()) : nullptr;
+    }
+
+    // Значение, которое переживёт эту версию карты
+    std::shared_ptr<const T> get(int id) const noexcept {
+        const std::shared_ptr<const void>* slot = slot_of(id);
+        return slot ? std::static_pointer_cast<const T>(*slot) : nullptr;
+    }
+
+    bool contains(int id) const noexcept {
+        return slot_of(id) != nullptr;
+    }
+
+    const T& at(int id) const {
+        const T* value = find(id);
+        if(!value) throw std::out_of_range("PersistentIdMap: id not found");
+        return *value;
+    }
+
+    void insert_or_assign(int id, std::shared_ptr<const T> value) {
+        assign(id, std::move(value), 0);
+    }
+
+    void insert_or_assign(int id, T value) {
+        insert_or_assign(id, std::make_shared<const T>(std::move(value)));
+    }
+
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    const_iterator begin() const { return const_iterator(root_.get(), depth_); }
+    const_iterator end() const noexcept { return const_iterator(); }
+
+private:
+    std::shared_ptr<const Node> root_;
+    int depth_ = 1;
+    size_t size_ = 0;
+
+    static uint64_t next_owner() noexcept {
+        static std::atomic<uint64_t> counter{0};
+        return ++counter;
+    }
+
+    static size_t shift_of(int level, int depth) noexcept {
+        return static_cast<size_t>(bits * (depth - 1 - level));
+    }
+
+    const std::shared_ptr<const void>* slot_of(int id) const noexcept {
+        if(id < 0 || !root_) return nullptr;
+        const auto key = static_cast<uint64_t>(id);
+        if(key >> (bits * depth_)) return nullptr;
+
+        const Node* node = root_.get();
+        for(int level = 0;; ++level) {
+            const auto& slot = node->slots[(key >> shift_of(level, depth_)) & (fanout - 1)];
+            if(!slot) return nullptr;
+            if(level == depth_ - 1) return &slot;
+            node = static_cast<const Node*>(slot.get());
+        }
+    }
+
+    // Узел, который можно менять: свой узел builder'а или копия чужого
+    static Node* writable(std::shared_ptr<const void>& slot, uint64_t owner) {
+        const auto* node = static_cast<const Node*>(slot.get());
+        if(owner != 0 && node && node->owner == owner) {
+            // Узел создан этим builder'ом как неконстантный и ещё не опубликован
+            return const_cast<Node*>(node);
+        }
+        auto copy = node ? std::make_shared<Node>(*node) : std::make_shared<Node>();
+        copy->owner = owner;
+        Node* raw = copy.get();
+        slot = std::move(copy);
+        return raw;
+    }
+
+    // owner = 0 - копировать весь путь (опубликованные версии не меняются)
+    void assign(int id, std::shared_ptr<const T> value, uint64_t owner) {
+        if(id < 0) throw std::invalid_argument("PersistentIdMap: negative id");
+        if(!value) throw std::invalid_argument("PersistentIdMap: null value");
+
+        const auto key = static_cast<uint64_t>(id);
+        while(key >> (bits * depth_)) {
+            // Старое дерево становится нулевым поддеревом нового корня
+            if(root_) {
+                auto grown = std::make_shared<Node>();
+                grown->owner = owner;
+                grown->slots[0] = std::move(root_);
+                root_ = std::move(grown);
+            }
+            ++depth_;
+        }
+
+        std::shared_ptr<const void> root = std::move(root_);
+        Node* node = writable(root, owner);
+        root_ = std::static_pointer_cast<const Node>(root);
+        for(int level = 0;; ++level) {
+            auto& slot = node->slots[(key >> shift_of(level, depth_)) & (fanout - 1)];
+            if(level == depth_ - 1) {
+                if(!slot) ++size_;
+                slot = std::move(value);
+                return;
+            }
+            node = writable(slot, owner);
+        }
+    }
+};
+
+template<typename T>
+class PersistentIdMap<T>::Builder {
+public:
+    Builder() : owner_(next_owner()) {}
+    // Продолжает существующую версию: её узлы копируются при первом изменении
+    explicit Builder(PersistentIdMap base) : map_(std::move(base)), owner_(next_owner()) {}
+
+    Builder(const Builder&) = delete;
+    Builder& operator=(const Builder&) = delete;
+
+    void insert_or_assign(int id, std::shared_ptr<const T> value) {
+        map_.assign(id, std::move(value), owner_);
+    }
+
+    void insert_or_assign(int id, T value) {
+        insert_or_assign(id, std::make_shared<const T>(std::move(value)));
+    }
+
+    const T* find(int id) const noexcept { return map_.find(id); }
+    bool contains(int id) const noexcept { return map_.contains(id); }
+    size_t size() const noexcept { return map_.size(); }
+
+    // После build() узлы больше не меняются: builder начинает с пустой карты
+    // и новым владельцем
+    PersistentIdMap build() {
+        PersistentIdMap result = std::move(map_);
+        map_ = PersistentIdMap();
+        owner_ = next_owner();
+        return result;
+    }
+
+private:
+    PersistentIdMap map_;
+    uint64_t owner_;
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../models/Seat.h"
+#include "../models/Tariff.h"
+#include <array>
+#include <cstdint>
+#include <ctime>
+#include <optional>
+#include <vector>
+
+// Тарифы, расписание периодов и скидки, скомпилированные в кусочно-постоянную
+// шкалу ставок. Точки смены ставки общие для всех типов мест, для каждого
+// типа хранятся ставка на отрезке и префиксные суммы стоимости, поэтому цена
+// любого интервала внутри горизонта считается за O(log n).
+class PricingEngine {
+public:
+    static constexpr size_t seat_type_count = static_cast<size_t>(Seat::Type::Conference) + 1;
+    static constexpr size_t period_count = static_cast<size_t>(Tariff::Period::Holiday) + 1;
+
+    // Период для каждого часа недели по местному времени, 0 - понедельник 00:00
+    using WeekSchedule = std::array<Tariff::Period, 7 * 24>;
+
+    // Будни с 18:00 и выходные - Peak, остальное время - OffPeak
+    static WeekSchedule default_schedule();
+
+    PricingEngine();
+
+    // Тариф действует для типа места в свой период (Tariff::period()).
+    // Если для периода тарифа нет, используется тариф Peak этого типа.
+    void set_tariff(Seat::Type type, const Tariff& tariff);
+    void set_schedule(const WeekSchedule& schedule);
+    void add_holiday(time_t start, time_t end);
+
+    // Строит шкалу на [from, to). Изменения настроек применяются при
+    // следующей компиляции.
+    void compile(time_t from, time_t to);
+    bool covers(time_t start, time_t end) const noexcept;
+
+    // Стоимость [start, end), округлённая до копеек. Вне горизонта - out_of_range.
+    double price(Seat::Type type, time_t start, time_t end) const;
+
+    // Столбцы пакетного расчёта (struct-of-arrays), seat_type - Seat::Type
+    struct BatchColumns {
+        std::vector<time_t> start;
+        std::vector<time_t> end;
+        std::vector<int32_t> seat_type;
+    };
+
+    // Цены пакета, совпадающие с price() побитово. На x86-64 с AVX2 считается
+    // по четыре брони за шаг, иначе - скалярно. Все интервалы проверяются
+    // до расчёта: invalid_argument / out_of_range как у price().
+    std::vector<double> price_batch(const BatchColumns& batch) const;
+    void price_batch_scalar(const BatchColumns& batch, double* out) const;
+    static bool simd_available() noexcept;
+
+    // Скомпилированная шкала: breakpoints[i] - начало i-го отрезка,
+    // последний элемент - конец горизонта
+    const std::vector<time_t>& breakpoints() const noexcept { return breakpoints_; }
+    const std::vector<double>& rates(Seat::Type type) const noexcept;
+    const std::vector<double>& prefix(Seat::Type type) const noexcept;
+
+    // Общая формула для скалярного и пакетного расчёта
+    static double round_price(double cost) noexcept;
+
+private:
+    struct Holiday {
+        time_t start;
+        time_t end;
+    };
+
+    std::array<std::array<std::optional<Tariff>, period_count>, seat_type_count> tariffs_;
+    WeekSchedule schedule_;
+    std::vector<Holiday> holidays_;
+
+    std::vector<time_t> breakpoints_;
+    std::array<std::vector<double>, seat_type_count> rates_;    // За секунду
+    std::array<std::vector<double>, seat_type_count> prefix_;   // Стоимость до breakpoints_[i]
+    // Те же ставки и суммы подряд по типам ([type * breakpoints + i]) для
+    // векторных gather; ставка последней точки равна нулю
+    std::vector<double> flat_rates_;
+    std::vector<double> flat_prefix_;
+
+    Tariff::Period period_at(time_t t) const;
+    double rate_at(Seat::Type type, Tariff::Period period, time_t t) const;
+    const Tariff* tariff_for(Seat::Type type, Tariff::Period period) const;
+    double cost_until(size_t type, time_t t) const;
+    void validate_batch(const BatchColumns& batch) const;
+    void price_batch_avx2(const BatchColumns& batch, double* out) const;
+};
@@ -5,9 +5,19 @@
 #include "../models/Client.h"
 #include "../models/Seat.h"
 #include "DatabaseManager.h"
+#include "SeatSchedule.h"
+#include "ReservationStore.h"
+#include "PricingEngine.h"
 #include <algorithm>
+#include <functional>
+#include <future>
+#include <optional>
+#include <mutex>
+#include <shared_mutex>
 #include <vector>
+#include <string>
 #include <stdexcept>
+#include <unordered_map>
 
 class ClubSystem; 
 
@@ -17,28 +27,94 @@ public:
     
     Reservation create_reservation(int client_id, int seat_id,
                                   time_t start, time_t end);
+    // То же в пишущем потоке БД: вызывающий поток не ждёт записи
+    std::future<Reservation> create_reservation_async(int client_id, int seat_id,
+                                                      time_t start, time_t end);
+
+    struct Request {
+        int client_id;
+        int seat_id;
+        time_t start;
+        time_t end;
+    };
+
+    struct Result {
+        std::optional<Reservation> reservation;
+        std::string error;
+
+        bool ok() const noexcept { return reservation.has_value(); }
+    };
+
+    // Пакетное бронирование: запросы проверяются в памяти друг против друга
+    // и против существующих броней, принятые вставляются одной транзакцией.
+    // Строка, отклонённая БД, получает ошибку, остальные вставляются.
+    // Результаты идут в порядке запросов; при пересечении побеждает более ранний.
+    std::vector<Result> create_reservations(const std::vector<Request>& requests);
     void cancel_reservation(int reservation_id);
+    void complete_reservation(int reservation_id);
+    // Загружает все брони в память (хранилище и расписание мест) через
+    // читающее соединение текущего потока
+    void load();
     
     std::vector<Reservation> find_reservations(
         int client_id = -1, 
         int seat_id = -1,
         Reservation::Status status = Reservation::Status::ANY) const;
 
+    // Обход без материализации всей выборки. fn вызывается под блокировкой
+    // чтения хранилища и не должен изменять брони.
+    void for_each_reservation(
+        int client_id,
+        int seat_id,
+        Reservation::Status status,
+        const std::function<void(const Reservation&)>& fn) const;
+
+    // Постраничная выборка по индексам хранилища
+    using Query = ReservationStore::Query;
+    using Page = ReservationStore::Page;
+    using Order = ReservationStore::Order;
+    Page query_reservations(const Query& query) const;
+
     struct TimeSlot { time_t start; time_t end; };
     bool is_available(int seat_id, const TimeSlot& slot) const;
+    // Цена по тарифам типа места с учётом периодов, праздников и скидок
     double calculate_price(const Seat& seat, const TimeSlot& slot);
+    // Пакетный расчёт по столбцам; шкала расширяется под весь пакет сразу
+    std::vector<double> calculate_prices(const PricingEngine::BatchColumns& batch);
+
+    // Новые цены броней с заданным статусом по текущим тарифам
+    // (ids[i] - бронь, prices[i] - её цена). В базу ничего не пишется.
+    struct Repricing {
+        std::vector<int> ids;
+        std::vector<double> prices;
+    };
+    Repricing reprice_reservations(Reservation::Status status);
+    // Изменяет настройки тарифов и перекомпилирует шкалу цен
+    void configure_pricing(const std::function<void(PricingEngine&)>& change);
     int get_last_insert_id() const;
 
 private:
     ClubSystem& clubSystem_;
     DatabaseManager& db_;
+    SeatSchedule schedule_;
+    mutable std::mutex schedule_mutex_;
+    // Берётся после schedule_mutex_, если нужны обе блокировки
+    ReservationStore store_;
+    mutable std::shared_mutex store_mutex_;
+    // Порядок изменений броней, записываемых групповой фиксацией: номер
+    // выдаётся вместе с постановкой в очередь, в store_ попадает только
+    // изменение новее уже применённого (под store_mutex_)
+    std::mutex submit_mutex_;
+    uint64_t write_sequence_ = 0;
+    std::unordered_map<int, uint64_t> applied_writes_;
+    PricingEngine pricing_;
+    mutable std::shared_mutex pricing_mutex_;
     
     Reservation load_reservation(int id) const;
     void save_reservation(const Reservation& r);
     void validate_time_slot(const TimeSlot& slot) const;
+    void configure_default_tariffs();
     
-    static Reservation create_from_db_row(const std::vector<std::string>& row);
+    static Reservation create_from_db_row(const DatabaseManager::Row& row);
     static std::string build_where_clause(const std::vector<std::string>& conditions);
-    std::string join_strings(const std::vector<std::string>& vec, 
-        const std::string& delimiter) const;
 };
\ No newline at end of file
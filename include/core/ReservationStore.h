@@ -0,0 +1,78 @@
+#pragma once
+
+#include "IdMap.h"
+#include "../models/Reservation.h"
+#include <array>
+#include <ctime>
+#include <functional>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Все брони в памяти с вторичными индексами по клиенту, месту и статусу.
+// Ключ индексов - (start_time, id), поэтому обход любого индекса идёт
+// по времени начала. SQLite остаётся постоянным хранилищем.
+class ReservationStore {
+public:
+    using Key = std::pair<time_t, int>;
+    using Index = std::set<Key>;
+
+    enum class Order { StartAsc, StartDesc };
+
+    // Выборка страницы. Окно [from, to) отбирает брони, пересекающиеся с ним
+    // (0 - без границы). Пагинация по ключу: следующая страница начинается
+    // после брони (after_start, after_id), after_id = -1 - с начала.
+    struct Query {
+        int client_id = -1;
+        int seat_id = -1;
+        Reservation::Status status = Reservation::Status::ANY;
+        time_t from = 0;
+        time_t to = 0;
+        Order order = Order::StartAsc;
+        time_t after_start = 0;
+        int after_id = -1;
+        size_t limit = 50;
+    };
+
+    struct Page {
+        std::vector<Reservation> items;
+        bool has_more = false;      // Курсор следующей страницы - последний элемент
+    };
+
+    void clear();
+    void reserve(size_t count);
+
+    // Добавляет бронь или заменяет существующую с тем же id
+    void upsert(const Reservation& reservation);
+
+    const Reservation* find(int id) const noexcept;
+    size_t size() const noexcept;
+
+    // Брони под фильтры (-1 и ANY - без фильтра). Обход идёт по самому
+    // короткому из подходящих индексов, без фильтров - в порядке добавления.
+    void for_each(int client_id,
+                  int seat_id,
+                  Reservation::Status status,
+                  const std::function<void(const Reservation&)>& fn) const;
+
+    // Стоимость не зависит от общего числа броней: поиск начала страницы по
+    // индексу и не более limit подходящих записей
+    Page query(const Query& query) const;
+
+private:
+    static constexpr size_t status_count = static_cast<size_t>(Reservation::Status::ANY);
+
+    IdMap<Reservation> reservations_;
+    std::unordered_map<int, Index> by_client_;
+    std::unordered_map<int, Index> by_seat_;
+    std::array<Index, status_count> by_status_;
+    Index by_start_;
+    time_t max_duration_ = 0;       // Ограничивает окно поиска слева по времени начала
+
+    void index(const Reservation& reservation);
+    void unindex(const Reservation& reservation);
+
+    static const Index* lookup(const std::unordered_map<int, Index>& indexes, int key);
+    const Index* narrowest_index(int client_id, int seat_id, Reservation::Status status) const;
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "DatabaseManager.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Журнал продаж. record() дописывает продажу в кольцевой буфер и обновляет
+// итоги в памяти, не обращаясь к БД. Фоновый поток переносит накопленные
+// продажи в таблицу sales порциями - одной транзакцией вместе со списанием
+// остатков товаров. Итоги по товарам, часам и суткам хранятся готовыми:
+// запросы выручки не просматривают журнал.
+//
+// Продажа, которую БД отклоняет из-за самой строки (ограничение, триггер),
+// откладывается в rejected(): её итоги вычитаются, а обработчик отказа
+// возвращает товар на склад. При временных ошибках БД продажи остаются в
+// кольце и записываются следующими попытками.
+class SalesLedger {
+public:
+    struct Sale {
+        int product_id;
+        int client_id;      // 0 - продажа без клиента
+        int quantity;
+        double amount;
+        time_t sold_at;
+    };
+
+    struct Totals {
+        int64_t sales = 0;
+        int64_t quantity = 0;
+        double revenue = 0.0;
+    };
+
+    // Продажа, которую не удалось записать в БД, и текст ошибки
+    struct Rejected {
+        Sale sale;
+        std::string error;
+    };
+
+    static constexpr size_t capacity = 65536;  // При заполнении record() пишет кольцо сам
+    static constexpr size_t batch_size = 1024; // Порция, запись которой начинается сразу
+    static constexpr std::chrono::milliseconds max_delay{200};
+
+    using RejectHandler = std::function<void(const Sale&)>;
+
+    explicit SalesLedger(DatabaseManager& db);
+    ~SalesLedger();
+
+    SalesLedger(const SalesLedger&) = delete;
+    SalesLedger& operator=(const SalesLedger&) = delete;
+
+    // Итоги по продажам, уже записанным в БД; вызывается до start()
+    void load();
+    // Вызывается для каждой отклонённой продажи, до start()
+    void set_reject_handler(RejectHandler handler);
+    void start();
+    // Останавливает фоновую запись и дописывает все продажи
+    void stop();
+
+    void record(const Sale& sale);
+    // Записывает накопленные продажи в БД до возврата
+    void flush();
+    size_t pending() const;
+    // Продажи, отклонённые БД; в итогах они не учитываются
+    std::vector<Rejected> rejected() const;
+
+    Totals total() const;
+    Totals product_totals(int product_id) const;
+    // Час [k * 3600, (k + 1) * 3600) и местные сутки, содержащие момент t
+    Totals hour_totals(time_t t) const;
+    Totals day_totals(time_t t) const;
+
+private:
+    DatabaseManager& db_;
+
+    std::vector<Sale> ring_;
+    uint64_t head_ = 0;     // Сколько продаж записано в кольцо
+    uint64_t tail_ = 0;     // Сколько из них перенесено в БД
+    mutable std::mutex mutex_;
+    std::condition_variable flush_cv_;
+    std::mutex flush_mutex_;
+    std::thread flusher_;
+    bool stop_ = false;
+    std::vector<Rejected> rejected_;
+    RejectHandler on_reject_;
+
+    Totals total_;
+    std::unordered_map<int, Totals> by_product_;
+    std::unordered_map<int64_t, Totals> by_hour_;
+    std::unordered_map<time_t, Totals> by_day_;
+    time_t day_begin_ = 0;  // Границы суток последней продажи
+    time_t day_end_ = 0;
+
+    void flusher_loop();
+    void stop_flusher();
+    void write_pending();
+    void flush_each();
+    void reject(const std::vector<Rejected>& failed, size_t done);
+    void write(const std::vector<Sale>& sales);
+    time_t day_of(time_t t);
+
+    static void add(Totals& totals, int64_t sales, int64_t quantity, double revenue) noexcept;
+};
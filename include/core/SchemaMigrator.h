@@ -0,0 +1,29 @@
+#pragma once
+
+#include "DatabaseManager.h"
+#include <string>
+#include <vector>
+
+// Версионированные миграции схемы. Текущая версия хранится в PRAGMA user_version,
+// каждая миграция применяется один раз в собственной транзакции.
+class SchemaMigrator {
+public:
+    struct Migration {
+        int version;
+        std::vector<std::string> statements;
+    };
+
+    explicit SchemaMigrator(DatabaseManager& db);
+
+    int current_version() const;
+    static int latest_version();
+
+    // Возвращает количество применённых миграций
+    int migrate();
+
+private:
+    DatabaseManager& db_;
+
+    static const std::vector<Migration>& migrations();
+    void apply(const Migration& migration);
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <ctime>
+#include <map>
+#include <unordered_map>
+
+// Занятость мест в памяти: для каждого места - брони (Pending/Active),
+// упорядоченные по времени начала. Интервалы полуоткрытые [start, end).
+class SeatSchedule {
+public:
+    void clear() noexcept;
+
+    void add(int seat_id, int reservation_id, time_t start, time_t end);
+    bool remove(int seat_id, int reservation_id, time_t start);
+
+    bool is_free(int seat_id, time_t start, time_t end) const;
+    size_t size() const noexcept;
+
+private:
+    struct Booking {
+        time_t end;
+        int reservation_id;
+    };
+
+    struct Timeline {
+        std::multimap<time_t, Booking> bookings;
+        time_t max_duration = 0;    // Ограничивает окно поиска пересечений слева
+    };
+
+    std::unordered_map<int, Timeline> seats_;
+    size_t size_ = 0;
+};
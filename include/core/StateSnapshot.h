@@ -0,0 +1,40 @@
+#pragma once
+
+#include "PersistentIdMap.h"
+#include "../models/Client.h"
+#include "../models/Seat.h"
+#include "../models/Product.h"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+// Бинарный снимок мест, клиентов и товаров для быстрого запуска.
+// Формат: заголовок, массивы записей фиксированного размера и общая таблица
+// строк; записи ссылаются на строки по смещению и длине. Файл читается через
+// mmap, целостность проверяется контрольной суммой, актуальность - номером
+// поколения из таблицы meta.
+class StateSnapshot {
+public:
+    using SeatMap = PersistentIdMap<Seat>;
+    using ClientMap = PersistentIdMap<Client>;
+    using ProductMap = PersistentIdMap<Product>;
+
+    struct Contents {
+        SeatMap seats;
+        ClientMap clients;
+        ProductMap products;
+    };
+
+    static constexpr uint32_t format_version = 1;
+
+    // Пишет во временный файл и атомарно заменяет path
+    static void write(const std::string& path,
+                      int64_t generation,
+                      const SeatMap& seats,
+                      const ClientMap& clients,
+                      const ProductMap& products);
+
+    // nullopt, если файла нет, он повреждён или относится к другому поколению
+    static std::optional<Contents> read(const std::string& path, int64_t generation);
+};
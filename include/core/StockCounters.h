@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+// Остатки товаров для одновременных продаж без блокировок. Продажа
+// двухфазная: reserve() уменьшает доступный остаток через CAS и не даёт
+// продать больше, чем есть; после регистрации продажи commit() списывает
+// товар с фактического остатка, при ошибке release() возвращает резерв.
+//
+// Счётчики лежат в блоках по id товара, блоки не перемещаются и живут до
+// разрушения объекта, поэтому чтение и продажи не берут мьютекс.
+class StockCounters {
+public:
+    StockCounters() = default;
+    ~StockCounters();
+
+    StockCounters(const StockCounters&) = delete;
+    StockCounters& operator=(const StockCounters&) = delete;
+
+    // Начинает учёт товара (или заменяет его остаток)
+    void set(int product_id, int stock);
+
+    bool reserve(int product_id, int quantity) noexcept;
+    void commit(int product_id, int quantity) noexcept;
+    void release(int product_id, int quantity) noexcept;
+    // Отменяет commit(): продажа не состоялась уже после списания
+    void restock(int product_id, int quantity) noexcept;
+
+    // -1, если товар не учитывается
+    int on_hand(int product_id) const noexcept;
+    int available(int product_id) const noexcept;
+
+private:
+    // Отдельная строка кэша на товар: кассы не мешают друг другу
+    struct alignas(64) Counter {
+        std::atomic<int> available{-1};
+        std::atomic<int> on_hand{-1};
+    };
+
+    static constexpr size_t block_size = 1024;
+    static constexpr size_t directory_size = 4096;
+
+    struct Block {
+        std::array<Counter, block_size> counters;
+    };
+
+    std::array<std::atomic<Block*>, directory_size> blocks_{};
+    std::mutex grow_mutex_;
+
+    Counter* find(int product_id) const noexcept;
+};
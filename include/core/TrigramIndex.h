@@ -0,0 +1,43 @@
+#pragma once
+
+#include "IdMap.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Индекс подстрочного поиска по триграммам кодовых точек.
+// Тексты приводятся к нижнему регистру (Utf8::fold), для каждой триграммы
+// хранится отсортированный список id. Запрос пересекает списки своих
+// триграмм и проверяет кандидатов по сохранённому свёрнутому тексту.
+// Для запросов из одного-двух символов индексируются также отдельные
+// символы и биграммы: их список и есть ответ, без проверки текстов.
+class TrigramIndex {
+public:
+    void clear();
+    void reserve(size_t count);
+
+    // Несколько полей одного документа индексируются вместе
+    void add(int id, const std::vector<std::string_view>& fields);
+    void remove(int id);
+
+    // Отсортированные по возрастанию id документов, содержащих query
+    std::vector<int> search(std::string_view query) const;
+
+    size_t size() const noexcept;
+
+private:
+    // Символ, биграмма или триграмма; длина n-граммы входит в ключ
+    using Gram = uint64_t;
+
+    std::unordered_map<Gram, std::vector<int>> postings_;
+    IdMap<std::string> folded_;
+
+    // n-граммы длины length без уже встреченных, для length 1..3
+    static void grams_of(const std::u32string& text, size_t length, std::vector<Gram>& out);
+    // Все n-граммы документа: символы, биграммы и триграммы
+    static std::vector<Gram> document_grams(const std::u32string& text);
+    static void insert_sorted(std::vector<int>& list, int id);
+    static void erase_sorted(std::vector<int>& list, int id);
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// Разбор UTF-8 и приведение к нижнему регистру для поиска клиентов.
+// Поддерживаются ASCII, Latin-1 и кириллица, включая Ё/ё.
+class Utf8 {
+public:
+    static std::u32string decode(std::string_view text);
+    static void append(std::string& out, char32_t code_point);
+
+    static char32_t fold(char32_t code_point) noexcept;
+    static std::u32string fold_decode(std::string_view text);
+    static std::string fold(std::string_view text);
+};
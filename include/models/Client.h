@@ -1,15 +1,21 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <regex>
+#include <stdexcept>
 #include <ctime>
 #include <algorithm>
 
 class Client {
 public:
+    // Метка для загрузки из БД: контакт уже проверен при сохранении
+    struct Trusted {};
+    static constexpr Trusted trusted{};
+
     Client(int id, std::string name, std::string contact);
     Client(int id, std::string name, std::string contact, time_t registered);
+    Client(Trusted, int id, std::string name, std::string contact, time_t registered);
     
     void update_contact(const std::string& new_contact);
     void add_reservation(int reservation_id);
@@ -21,6 +27,11 @@ public:
     const std::vector<int>& reservations() const noexcept;
     bool has_active_bookings() const noexcept;
 
+    // ^\+7\d{10}$
+    static bool is_phone(std::string_view contact) noexcept;
+    // ^[a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,}$
+    static bool is_email(std::string_view contact) noexcept;
+
 private:
     int id_;
     std::string name_;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ctime>
+#include <string>
 #include <vector>
 #include <optional>
 #include <stdexcept>
@@ -9,6 +10,12 @@
 class Tariff {
 public:
     enum class Period { Peak, OffPeak, Holiday };
+
+    struct Discount {
+        double percent;
+        time_t start;
+        time_t end;
+    };
     
     Tariff(int id, std::string name, double base_rate, 
           Period period = Period::Peak);
@@ -26,6 +33,8 @@ public:
     const std::string& name() const noexcept;
     double current_rate() const;
     Period period() const noexcept;
+    double base_rate() const noexcept;
+    const std::vector<Discount>& discounts() const noexcept;
     
     void set_base_rate(double new_rate);
     void set_period(Period new_period);
@@ -35,12 +44,6 @@ private:
     std::string name_;
     double base_rate_;
     Period period_;
-    
-    struct Discount {
-        double percent;
-        time_t start;
-        time_t end;
-    };
     std::vector<Discount> discounts_;
     
     double current_discount() const;
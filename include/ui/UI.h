@@ -2,6 +2,7 @@
 
 #pragma once
 #include "../core/ClubSystem.h"
+#include "../core/Analytics.h"
 #include "../models/Client.h"
 #include <functional>
 #include <vector>
@@ -13,6 +14,8 @@
 #include <termios.h>
 #include <unistd.h>
 #include <climits>
+#include <future>
+#include <chrono>
 
 class UI {
 public:
@@ -43,12 +46,32 @@ private:
     void clientLookup();
     void showProducts();
     void addNewProduct();
+    void sellProduct();
+    void showRevenue();
     std::string productCategoryToString(Product::Category category);
     void printReservationDetails(const Reservation& res);
     std::string seatTypeToString(Seat::Type type);
     void seatManagementMenu();
     void changeSeatStatus();
+    void showReports();
     
+    // Запись идёт в пишущем потоке БД; если она затянулась (медленный
+    // диск), меню не замирает молча, а показывает индикатор ожидания
+    template<typename T>
+    T awaitResult(std::future<T> result);
+
     std::string format_time(time_t time);
     std::string status_to_string(Reservation::Status status);
-};
\ No newline at end of file
+};
+
+template<typename T>
+T UI::awaitResult(std::future<T> result) {
+    if(result.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready) {
+        std::cout << "Сохранение" << std::flush;
+        while(result.wait_for(std::chrono::milliseconds(250)) != std::future_status::ready) {
+            std::cout << '.' << std::flush;
+        }
+        std::cout << "\n";
+    }
+    return result.get();
+}
@@ -0,0 +1,199 @@
+#include "../../include/core/Analytics.h"
+#include "../../include/core/ReservationManager.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+constexpr size_t seat_type_count = static_cast<size_t>(Seat::Type::Conference) + 1;
+constexpr size_t min_rows_per_worker = 65536;
+
+// Счётчики одного потока
+struct Partial {
+    std::vector<int64_t> heat;                      // Секунды занятости: место x час недели
+    std::array<int64_t, seat_type_count> type_seconds{};
+    std::vector<double> revenue;
+    std::vector<int> reservations;
+};
+
+}
+
+void ReservationColumns::reserve(size_t count) {
+    id.reserve(count);
+    client_id.reserve(count);
+    seat_id.reserve(count);
+    start.reserve(count);
+    end.reserve(count);
+    cost.reserve(count);
+    status.reserve(count);
+}
+
+void ReservationColumns::push_back(const Reservation& reservation) {
+    id.push_back(reservation.id());
+    client_id.push_back(reservation.client_id());
+    seat_id.push_back(reservation.seat_id());
+    start.push_back(reservation.start_time());
+    end.push_back(reservation.end_time());
+    cost.push_back(static_cast<float>(reservation.total_cost()));
+    status.push_back(static_cast<uint8_t>(reservation.status()));
+}
+
+ReservationColumns Analytics::load(const ReservationManager& reservations, time_t from, time_t to) {
+    ReservationColumns columns;
+    reservations.for_each_reservation(-1, -1, Reservation::Status::ANY,
+        [&columns, from, to](const Reservation& reservation) {
+            if(reservation.start_time() < to && reservation.end_time() > from) {
+                columns.push_back(reservation);
+            }
+        });
+    return columns;
+}
+
+Analytics::Report Analytics::build(const ReservationColumns& columns, const PersistentIdMap<Seat>& seats,
+                                   time_t from, time_t to) {
+    if(from >= to) {
+        throw std::invalid_argument("Report window is empty");
+    }
+
+    Report report;
+    report.from = from;
+    report.to = to;
+    report.scanned = columns.size();
+
+    // Места: id -> номер строки тепловой карты
+    for(const auto& seat : seats) report.heatmap.seat_ids.push_back(seat.id());
+    std::sort(report.heatmap.seat_ids.begin(), report.heatmap.seat_ids.end());
+    const int max_seat = report.heatmap.seat_ids.empty() ? -1 : report.heatmap.seat_ids.back();
+    std::vector<int32_t> seat_index(static_cast<size_t>(max_seat + 1), -1);
+    std::vector<uint8_t> seat_type(report.heatmap.seat_ids.size());
+    std::array<int, seat_type_count> seats_of_type{};
+    for(size_t i = 0; i < report.heatmap.seat_ids.size(); ++i) {
+        const int id = report.heatmap.seat_ids[i];
+        seat_index[static_cast<size_t>(id)] = static_cast<int32_t>(i);
+        seat_type[i] = static_cast<uint8_t>(seats.find(id)->type());
+        ++seats_of_type[seat_type[i]];
+    }
+
+    // Часовая шкала окна: для каждого часа UTC - час недели и сутки по
+    // местному времени. Переходы на летнее время учитываются здесь один раз,
+    // и просмотр броней обходится без localtime.
+    const time_t base = from - ((from % 3600) + 3600) % 3600;
+    const size_t hours = static_cast<size_t>((to - base + 3599) / 3600);
+    std::vector<uint8_t> hour_slot(hours);
+    std::vector<int32_t> hour_day(hours);
+    std::array<int64_t, hours_per_week> slot_seconds{};
+    int last_yday = -1;
+    for(size_t k = 0; k < hours; ++k) {
+        const time_t hour = base + static_cast<time_t>(k) * 3600;
+        std::tm local{};
+        localtime_r(&hour, &local);
+        hour_slot[k] = static_cast<uint8_t>(((local.tm_wday + 6) % 7) * 24 + local.tm_hour);
+        if(local.tm_yday != last_yday) {
+            last_yday = local.tm_yday;
+            std::tm midnight = local;
+            midnight.tm_hour = midnight.tm_min = midnight.tm_sec = 0;
+            midnight.tm_isdst = -1;
+            report.revenue.push_back({std::mktime(&midnight)});
+        }
+        hour_day[k] = static_cast<int32_t>(report.revenue.size() - 1);
+        slot_seconds[hour_slot[k]] += std::min<time_t>(to, hour + 3600) - std::max(from, hour);
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    const size_t count = columns.size();
+    const size_t workers = std::max<size_t>(
+        1, std::min<size_t>(std::thread::hardware_concurrency(), count / min_rows_per_worker));
+    const size_t slice = (count + workers - 1) / workers;
+    const size_t days = report.revenue.size();
+    const int64_t window_from = from;
+    const int64_t window_to = to;
+
+    const auto scan = [&](size_t lo, size_t hi, Partial& partial) {
+        partial.heat.assign(seat_type.size() * hours_per_week, 0);
+        partial.revenue.assign(days, 0.0);
+        partial.reservations.assign(days, 0);
+
+        const auto cancelled = static_cast<uint8_t>(Reservation::Status::Cancelled);
+        for(size_t i = lo; i < hi; ++i) {
+            if(columns.status[i] == cancelled) continue;
+            const int64_t start = columns.start[i];
+            const int64_t end = columns.end[i];
+
+            if(start >= window_from && start < window_to) {
+                const int32_t day = hour_day[static_cast<size_t>((start - base) / 3600)];
+                partial.revenue[day] += columns.cost[i];
+                ++partial.reservations[day];
+            }
+
+            const int64_t s = std::max(start, window_from);
+            const int64_t e = std::min(end, window_to);
+            const int32_t seat = columns.seat_id[i];
+            if(s >= e || seat < 0 || seat > max_seat) continue;
+            const int32_t index = seat_index[static_cast<size_t>(seat)];
+            if(index < 0) continue;
+
+            partial.type_seconds[seat_type[index]] += e - s;
+            int64_t* row = partial.heat.data() + static_cast<size_t>(index) * hours_per_week;
+            for(size_t h = static_cast<size_t>((s - base) / 3600);; ++h) {
+                const int64_t hour_start = base + static_cast<int64_t>(h) * 3600;
+                const int64_t hour_end = hour_start + 3600;
+                row[hour_slot[h]] += std::min(e, hour_end) - std::max(s, hour_start);
+                if(hour_end >= e) break;
+            }
+        }
+    };
+
+    std::vector<Partial> partials(workers);
+    std::vector<std::future<void>> tasks;
+    for(size_t w = 1; w < workers; ++w) {
+        const size_t lo = std::min(count, w * slice);
+        const size_t hi = std::min(count, lo + slice);
+        tasks.push_back(std::async(std::launch::async, [&, lo, hi, w] {
+            scan(lo, hi, partials[w]);
+        }));
+    }
+    scan(0, std::min(count, slice), partials[0]);
+    for(auto& task : tasks) task.get();
+
+    Partial& total = partials[0];
+    for(size_t w = 1; w < workers; ++w) {
+        for(size_t i = 0; i < total.heat.size(); ++i) total.heat[i] += partials[w].heat[i];
+        for(size_t t = 0; t < seat_type_count; ++t) total.type_seconds[t] += partials[w].type_seconds[t];
+        for(size_t d = 0; d < days; ++d) {
+            total.revenue[d] += partials[w].revenue[d];
+            total.reservations[d] += partials[w].reservations[d];
+        }
+    }
+
+    report.heatmap.occupancy.resize(total.heat.size());
+    for(size_t i = 0; i < total.heat.size(); ++i) {
+        const int64_t available = slot_seconds[i % hours_per_week];
+        report.heatmap.occupancy[i] = available > 0
+            ? static_cast<double>(total.heat[i]) / static_cast<double>(available)
+            : 0.0;
+    }
+
+    const double window = static_cast<double>(to - from);
+    for(size_t t = 0; t < seat_type_count; ++t) {
+        TypeUtilization utilization;
+        utilization.type = static_cast<Seat::Type>(t);
+        utilization.seats = seats_of_type[t];
+        utilization.occupied_hours = static_cast<double>(total.type_seconds[t]) / 3600.0;
+        utilization.utilization = seats_of_type[t] > 0
+            ? static_cast<double>(total.type_seconds[t]) / (window * seats_of_type[t])
+            : 0.0;
+        report.by_type.push_back(utilization);
+    }
+
+    for(size_t d = 0; d < days; ++d) {
+        report.revenue[d].revenue = total.revenue[d];
+        report.revenue[d].reservations = total.reservations[d];
+    }
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return report;
+}
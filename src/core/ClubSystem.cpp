@@ -1,21 +1,247 @@
 #include "../../include/core/ClubSystem.h"
+#include <charconv>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <unordered_set>
 
 namespace fs = std::filesystem;
 
+namespace {
+
+constexpr size_t import_chunk_rows = 8192;
+
+struct ParsedClient {
+    std::string name;
+    std::string contact;
+    time_t registered;
+};
+
+struct ParsedProduct {
+    std::string name;
+    Product::Category category;
+    double price;
+    int stock;
+};
+
+// Описание импорта одной таблицы: проверка строки CSV, параметры вставки
+// и обработка зафиксированных записей
+template<typename Parsed>
+struct ImportPlan {
+    const char* header;                 // Первое поле строки заголовка
+    const char* insert_prefix;          // "INSERT INTO t (a, b) VALUES "
+    const char* row_placeholders;       // "(?, ?)"
+    size_t rows_per_insert;             // Не превышает лимит параметров SQLite
+    std::function<bool(const CsvReader::Record&, Parsed&, std::string&)> validate;
+    std::function<bool(const Parsed&, std::string&)> accept;   // Последовательная проверка
+    std::function<void(const Parsed&, std::vector<DatabaseManager::Value>&)> bind;
+    std::function<void(int, Parsed&&)> committed;
+};
+
+std::string_view trim(std::string_view text) {
+    const auto first = text.find_first_not_of(" \t");
+    if(first == std::string_view::npos) return {};
+    const auto last = text.find_last_not_of(" \t");
+    return text.substr(first, last - first + 1);
+}
+
+bool equals_ascii_nocase(std::string_view a, std::string_view b) {
+    if(a.size() != b.size()) return false;
+    for(size_t i = 0; i < a.size(); ++i) {
+        if(std::tolower(static_cast<unsigned char>(a[i])) !=
+           std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Number>
+bool parse_number(std::string_view text, Number& value) {
+    text = trim(text);
+    const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+// strtod: from_chars для double есть не во всех стандартных библиотеках
+bool parse_price(std::string_view text, double& value) {
+    const std::string copy(trim(text));
+    if(copy.empty()) return false;
+    char* end = nullptr;
+    value = std::strtod(copy.c_str(), &end);
+    return end == copy.c_str() + copy.size() && std::isfinite(value);
+}
+
+std::string insert_sql(const char* prefix, const char* placeholders, size_t rows) {
+    std::string sql(prefix);
+    for(size_t i = 0; i < rows; ++i) {
+        if(i > 0) sql += ", ";
+        sql += placeholders;
+    }
+    return sql;
+}
+
+template<typename Parsed>
+ClubSystem::ImportReport run_import(std::istream& csv, const ImportPlan<Parsed>& plan) {
+    auto& db = DatabaseManager::instance();
+    const auto started = std::chrono::steady_clock::now();
+
+    ClubSystem::ImportReport report;
+    CsvReader reader(csv);
+    std::vector<CsvReader::Record> records;
+    bool first_chunk = true;
+    bool more = true;
+
+    while(more) {
+        records.clear();
+        more = reader.read_chunk(import_chunk_rows, records);
+        if(records.empty()) break;
+
+        size_t begin = 0;
+        if(first_chunk) {
+            first_chunk = false;
+            if(!records[0].fields.empty() &&
+               equals_ascii_nocase(trim(records[0].fields[0]), plan.header)) {
+                begin = 1;
+            }
+        }
+        const size_t count = records.size() - begin;
+        report.rows += count;
+
+        // Проверка строк не зависит от соседних, поэтому порция делится
+        // между потоками по непересекающимся диапазонам
+        std::vector<Parsed> parsed(count);
+        std::vector<std::string> errors(count);
+        std::vector<char> valid(count, 0);
+        const size_t workers = std::max<size_t>(
+            1, std::min<size_t>(std::thread::hardware_concurrency(), count / 1024));
+        const size_t slice = (count + workers - 1) / workers;
+
+        std::vector<std::future<void>> tasks;
+        for(size_t w = 0; w < workers; ++w) {
+            const size_t from = w * slice;
+            const size_t to = std::min(count, from + slice);
+            if(from >= to) break;
+            tasks.push_back(std::async(std::launch::async, [&, from, to] {
+                for(size_t i = from; i < to; ++i) {
+                    const CsvReader::Record& record = records[begin + i];
+                    if(!record.error.empty()) {
+                        errors[i] = record.error;
+                        continue;
+                    }
+                    valid[i] = plan.validate(record, parsed[i], errors[i]);
+                }
+            }));
+        }
+        for(auto& task : tasks) task.get();
+
+        std::vector<size_t> accepted;
+        accepted.reserve(count);
+        for(size_t i = 0; i < count; ++i) {
+            if(valid[i] && plan.accept(parsed[i], errors[i])) {
+                accepted.push_back(i);
+            } else {
+                report.errors.push_back({records[begin + i].line, std::move(errors[i])});
+            }
+        }
+
+        std::vector<std::pair<size_t, int>> inserted;
+        inserted.reserve(accepted.size());
+        std::vector<DatabaseManager::Value> params;
+        // Транзакция порции удерживает соединение: записи других потоков
+        // не попадают в неё и не откатываются вместе с ней
+        db.transaction([&] {
+            for(size_t at = 0; at < accepted.size(); at += plan.rows_per_insert) {
+                const size_t rows = std::min(plan.rows_per_insert, accepted.size() - at);
+                params.clear();
+                for(size_t k = 0; k < rows; ++k) plan.bind(parsed[accepted[at + k]], params);
+
+                try {
+                    // Строки одного INSERT получают подряд идущие rowid
+                    const int64_t last = db.insert(
+                        insert_sql(plan.insert_prefix, plan.row_placeholders, rows), params);
+                    for(size_t k = 0; k < rows; ++k) {
+                        inserted.emplace_back(accepted[at + k],
+                                              static_cast<int>(last - static_cast<int64_t>(rows - 1 - k)));
+                    }
+                } catch(const std::exception&) {
+                    // Ошибка откатывает только этот INSERT: повторяем построчно,
+                    // чтобы найти и отчитаться о конкретных строках
+                    for(size_t k = 0; k < rows; ++k) {
+                        const size_t index = accepted[at + k];
+                        params.clear();
+                        plan.bind(parsed[index], params);
+                        try {
+                            const int64_t id = db.insert(
+                                insert_sql(plan.insert_prefix, plan.row_placeholders, 1), params);
+                            inserted.emplace_back(index, static_cast<int>(id));
+                        } catch(const std::exception& e) {
+                            report.errors.push_back({records[begin + index].line, e.what()});
+                        }
+                    }
+                }
+            }
+        });
+
+        for(auto& [index, id] : inserted) {
+            plan.committed(id, std::move(parsed[index]));
+        }
+        report.imported += inserted.size();
+    }
+
+    std::sort(report.errors.begin(), report.errors.end(),
+              [](const ClubSystem::ImportError& a, const ClubSystem::ImportError& b) {
+                  return a.line < b.line;
+              });
+    report.seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - started).count();
+    return report;
+}
+
+// Загрузчик во вспомогательном потоке закрывает своё читающее соединение
+template<typename Fn>
+void run_with_reader(Fn&& fn) {
+    try {
+        fn();
+    } catch(...) {
+        DatabaseManager::instance().release_reader();
+        throw;
+    }
+    DatabaseManager::instance().release_reader();
+}
+
+}
+
 ClubSystem::ClubSystem() 
-    : reservation_manager_(new ReservationManager(*this)) {}
+    : reservation_manager_(new ReservationManager(*this)),
+      seats_(std::make_shared<SeatMap>()),
+      clients_(std::make_shared<ClientMap>()),
+      products_(std::make_shared<ProductMap>()),
+      sales_(DatabaseManager::instance()) {
+    // Отклонённая БД продажа не списывает товар
+    sales_.set_reject_handler([this](const SalesLedger::Sale& sale) {
+        stock_.restock(sale.product_id, sale.quantity);
+    });
+}
 
 ClubSystem::~ClubSystem() {
+    if(clients_loading_.valid()) clients_loading_.wait();
+    if(data_loading_.valid()) data_loading_.wait();
+    stop_snapshot_timer();
     delete reservation_manager_;
 }
 
-void ClubSystem::initialize(const std::string& db_path) {
+void ClubSystem::initialize(const std::string& db_path, LoadMode mode) {
     try {
         fs::create_directories(fs::path(db_path).parent_path());
         auto& db = DatabaseManager::instance();
         db.connect(db_path);
+        snapshot_path_ = db_path + ".snap";
         setup_database();
-        load_data();
+        load_data(mode);
+        sales_.start();
+        start_snapshot_timer();
     } catch(const std::exception& e) {
         throw std::runtime_error("Initialization failed: " + std::string(e.what()));
     }
@@ -23,43 +249,7 @@ void ClubSystem::initialize(const std::string& db_path) {
 
 
 void ClubSystem::setup_database() {
-    auto& db = DatabaseManager::instance();
-    const std::vector<std::string> tables = {
-        R"(CREATE TABLE IF NOT EXISTS clients (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            name TEXT NOT NULL,
-            contact TEXT UNIQUE NOT NULL,
-            reg_date INTEGER NOT NULL))",
-        
-        R"(CREATE TABLE IF NOT EXISTS seats (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            type INTEGER NOT NULL,
-            status INTEGER NOT NULL,
-            hardware_spec TEXT))",
-        
-        R"(CREATE TABLE IF NOT EXISTS products (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            name TEXT NOT NULL,
-            category INTEGER NOT NULL,
-            price REAL NOT NULL,
-            stock INTEGER DEFAULT 0))",
-        
-        R"(CREATE TABLE IF NOT EXISTS reservations (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            client_id INTEGER NOT NULL,
-            seat_id INTEGER NOT NULL,
-            start_time INTEGER NOT NULL,
-            end_time INTEGER NOT NULL,
-            status INTEGER NOT NULL,
-            total_cost REAL NOT NULL,
-            FOREIGN KEY(client_id) REFERENCES clients(id),
-            FOREIGN KEY(seat_id) REFERENCES seats(id)))"
-    };
-
-    for(const auto& sql : tables) {
-        db.execute(sql);
-    } 
-
+    SchemaMigrator(DatabaseManager::instance()).migrate();
     initialize_default_seats();
 }
 
@@ -68,275 +258,834 @@ void ClubSystem::initialize_default_seats() {
         "SELECT COUNT(*) FROM seats"
     );
     
-    if(std::stoi(result[0].columns[0]) > 0) return;
+    if(result[0].get_int(0) > 0) return;
 
-    DatabaseManager::instance().begin_transaction();
-    try {
+    auto& db = DatabaseManager::instance();
+    db.transaction([&db] {
         for(int i = 1; i <= 60; ++i) {
-            DatabaseManager::instance().execute(
+            db.execute(
                 "INSERT INTO seats (type, status, hardware_spec) "
                 "VALUES (?, ?, ?)",
                 {
-                    std::to_string(static_cast<int>(Seat::Type::Standard)),
-                    std::to_string(static_cast<int>(Seat::Status::Free)),
+                    static_cast<int>(Seat::Type::Standard),
+                    static_cast<int>(Seat::Status::Free),
                     "CPU: Intel i5, RAM: 16GB, GPU: NVIDIA GTX 1660"
                 }
             );
         }
-        DatabaseManager::instance().commit_transaction();
-    } catch(...) {
-        DatabaseManager::instance().rollback_transaction();
-        throw;
-    }
+    });
     
     load_seats();
 }
 
 void ClubSystem::addSeat(const Seat& seat) {
-    auto& db = DatabaseManager::instance();
+    std::lock_guard<std::mutex> lock(write_mutex_);
     
-    db.execute(
+    const int64_t id = DatabaseManager::instance().insert(
         "INSERT INTO seats (type, status, hardware_spec) VALUES (?, ?, ?)",
         {
-            std::to_string(static_cast<int>(seat.type())),
-            std::to_string(static_cast<int>(seat.status())),
+            static_cast<int>(seat.type()),
+            static_cast<int>(seat.status()),
             seat.hardware_spec()
         }
     );
     
-    load_seats(); 
+    Seat stored(static_cast<int>(id), seat.type(), seat.status());
+    stored.update_hardware(seat.hardware_spec());
+    auto next = std::make_shared<SeatMap>(*std::atomic_load(&seats_));
+    next->insert_or_assign(stored.id(), std::move(stored));
+    publish(seats_, std::move(next));
 }
 
-void ClubSystem::load_data() {
+void ClubSystem::load_data(LoadMode mode) {
     try {
-        load_seats();
-        load_clients();
-        load_products();
+        // Снимок уже содержит места, клиентов и товары
+        const bool from_snapshot = load_snapshot();
+        if(mode == LoadMode::Sequential) {
+            if(!from_snapshot) {
+                load_seats();
+                load_clients();
+                load_products();
+            }
+            sales_.load();
+            reservation_manager_->load();
+            return;
+        }
+
+        if(!from_snapshot) {
+            clients_complete_ = false;
+            clients_loading_ = std::async(std::launch::async, [this] {
+                run_with_reader([this] { load_clients(); });
+            }).share();
+        }
+        // Первому экрану не нужны: товары, продажи и брони ждут те, кто к
+        // ним обращается
+        data_loading_ = std::async(std::launch::async, [this, from_snapshot] {
+            run_with_reader([this, from_snapshot] {
+                if(!from_snapshot) load_products();
+                sales_.load();
+                reservation_manager_->load();
+            });
+        }).share();
+        // Места нужны первому экрану, поэтому читаются в текущем потоке
+        if(!from_snapshot) load_seats();
     } catch(const std::exception& e) {
         throw std::runtime_error("Data loading failed: " + std::string(e.what()));
     }
 }
 
 void ClubSystem::load_seats() {
-    seats_.clear();
-    auto rows = DatabaseManager::instance().fetch_all(
-        "SELECT id, type, status, hardware_spec FROM seats"
+    SeatMap::Builder next;
+    DatabaseManager::instance().reader().for_each_row(
+        "SELECT id, type, status, hardware_spec FROM seats", {},
+        [&next](const DatabaseManager::Row& row) {
+            Seat seat(
+                row.get_int(0),
+                static_cast<Seat::Type>(row.get_int(1)),
+                static_cast<Seat::Status>(row.get_int(2))
+            );
+            seat.update_hardware(std::string(row.get_text(3)));
+            next.insert_or_assign(seat.id(), std::move(seat));
+        }
     );
-    
-    for(const auto& row : rows) {
-        Seat seat(
-            std::stoi(row.columns[0]),
-            static_cast<Seat::Type>(std::stoi(row.columns[1])),
-            static_cast<Seat::Status>(std::stoi(row.columns[2]))
-        );
-        seat.update_hardware(row.columns[3]);
-        seats_.push_back(std::move(seat));
-    }
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    publish(seats_, std::make_shared<SeatMap>(next.build()));
 }
 
 void ClubSystem::load_clients() {
-    clients_.clear();
-    auto rows = DatabaseManager::instance().fetch_all(
-        "SELECT id, name, contact, reg_date FROM clients"
+    ClientMap::Builder next;
+    DatabaseManager::instance().reader().for_each_row(
+        "SELECT id, name, contact, reg_date FROM clients", {},
+        [&next](const DatabaseManager::Row& row) {
+            const int id = row.get_int(0);
+            next.insert_or_assign(
+                id,
+                std::make_shared<const Client>(
+                    Client::trusted,
+                    id,
+                    std::string(row.get_text(1)),
+                    std::string(row.get_text(2)),
+                    static_cast<time_t>(row.get_int64(3))
+                )
+            );
+        }
     );
-    
-    for(const auto& row : rows) {
-        clients_.emplace(
-            std::stoi(row.columns[0]),
-            Client(
-                std::stoi(row.columns[0]),
-                row.columns[1],
-                row.columns[2],
-                std::stol(row.columns[3])
-            )
-        );
+    auto loaded = next.build();
+    TrigramIndex index;
+    FuzzyNameIndex names;
+    index_clients(loaded, index, names);
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    // Клиенты, созданные или подгруженные во время чтения, не старее
+    // прочитанных строк
+    const auto current = std::atomic_load(&clients_);
+    ClientMap::Builder merged(std::move(loaded));
+    for(const auto& client : *current) {
+        if(!merged.contains(client.id())) names.add(client.id(), client.name());
+        index.add(client.id(), {client.name(), client.contact()});
+        merged.insert_or_assign(client.id(), current->get(client.id()));
+    }
+    publish(clients_, std::make_shared<ClientMap>(merged.build()));
+    {
+        std::unique_lock<std::shared_mutex> index_lock(client_index_mutex_);
+        client_index_ = std::move(index);
+        client_names_ = std::move(names);
+    }
+    clients_complete_ = true;
+}
+
+void ClubSystem::index_clients(const ClientMap& clients,
+                               TrigramIndex& index, FuzzyNameIndex& names) {
+    index.reserve(clients.size());
+    for(const auto& client : clients) {
+        index.add(client.id(), {client.name(), client.contact()});
+        names.add(client.id(), client.name());
     }
 }
 
+void ClubSystem::build_client_indexes(const ClientMap& clients) {
+    TrigramIndex index;
+    FuzzyNameIndex names;
+    index_clients(clients, index, names);
+
+    std::unique_lock<std::shared_mutex> index_lock(client_index_mutex_);
+    client_index_ = std::move(index);
+    client_names_ = std::move(names);
+}
+
+std::shared_ptr<const Client> ClubSystem::fault_in_client(int client_id) const {
+    std::shared_ptr<const Client> loaded;
+    DatabaseManager::instance().reader().for_each_row(
+        "SELECT id, name, contact, reg_date FROM clients WHERE id = ?", {client_id},
+        [&loaded](const DatabaseManager::Row& row) {
+            loaded = std::make_shared<const Client>(
+                Client::trusted,
+                row.get_int(0),
+                std::string(row.get_text(1)),
+                std::string(row.get_text(2)),
+                static_cast<time_t>(row.get_int64(3))
+            );
+        }
+    );
+    if(!loaded) return nullptr;
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto current = std::atomic_load(&clients_);
+    if(auto existing = current->get(client_id)) return existing;
+    if(clients_complete_) return loaded;
+
+    auto next = std::make_shared<ClientMap>(*current);
+    next->insert_or_assign(client_id, loaded);
+    publish(clients_, std::move(next));
+    return loaded;
+}
+
+void ClubSystem::wait_for_clients() const {
+    // get() на общем объекте shared_future из нескольких потоков - гонка,
+    // у каждого вызывающего своя копия
+    const std::shared_future<void> loading = clients_loading_;
+    if(loading.valid()) loading.get();
+}
+
+void ClubSystem::wait_for_data() const {
+    const std::shared_future<void> loading = data_loading_;
+    if(loading.valid()) loading.get();
+}
+
 void ClubSystem::load_products() {
-    products_.clear();
-    auto rows = DatabaseManager::instance().fetch_all(
-        "SELECT id, name, category, price, stock FROM products"
+    ProductMap::Builder next;
+    DatabaseManager::instance().reader().for_each_row(
+        "SELECT id, name, category, price, stock FROM products", {},
+        [&next](const DatabaseManager::Row& row) {
+            const int id = row.get_int(0);
+            next.insert_or_assign(
+                id,
+                Product(
+                    id,
+                    std::string(row.get_text(1)),
+                    static_cast<Product::Category>(row.get_int(2)),
+                    row.get_double(3),
+                    row.get_int(4)
+                )
+            );
+        }
     );
-    
-    for(const auto& row : rows) {
-        products_.emplace(
-            std::stoi(row.columns[0]),
-            Product(
-                std::stoi(row.columns[0]),
-                row.columns[1],
-                static_cast<Product::Category>(std::stoi(row.columns[2])),
-                std::stod(row.columns[3]),
-                std::stoi(row.columns[4])
-            )
-        );
+    auto loaded = std::make_shared<ProductMap>(next.build());
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    track_stock(*loaded);
+    publish(products_, std::move(loaded));
+}
+
+void ClubSystem::track_stock(const ProductMap& products) {
+    for(const auto& product : products) {
+        stock_.set(product.id(), product.stock());
+    }
+}
+
+std::vector<Product> ClubSystem::current_products(const ProductMap& products) const {
+    std::vector<Product> result;
+    result.reserve(products.size());
+    for(const auto& product : products) {
+        const int stock = stock_.on_hand(product.id());
+        result.emplace_back(product.id(), product.name(), product.category(), product.price(),
+                            stock < 0 ? product.stock() : stock);
     }
+    return result;
 }
 
 Client ClubSystem::create_client(std::string name, std::string contact) {
-    auto& db = DatabaseManager::instance();
+    std::lock_guard<std::mutex> lock(write_mutex_);
     const time_t reg_date = time(nullptr);
     
-    db.execute(
+    const int id = static_cast<int>(DatabaseManager::instance().insert(
         "INSERT INTO clients (name, contact, reg_date) VALUES (?, ?, ?)",
-        {name, contact, std::to_string(reg_date)}
-    );
+        {name, contact, reg_date}
+    ));
     
-    auto result = db.fetch_all("SELECT last_insert_rowid()");
-    if(result.empty() || result[0].columns.empty()) {
-        throw std::runtime_error("Failed to retrieve client ID");
+    auto client = std::make_shared<const Client>(id, std::move(name), std::move(contact), reg_date);
+    auto next = std::make_shared<ClientMap>(*std::atomic_load(&clients_));
+    next->insert_or_assign(id, client);
+    publish(clients_, std::move(next));
+    {
+        std::unique_lock<std::shared_mutex> index_lock(client_index_mutex_);
+        client_index_.add(id, {client->name(), client->contact()});
+        client_names_.add(id, client->name());
     }
-    
-    const int id = std::stoi(result[0].columns[0]);
-    Client client(id, std::move(name), std::move(contact), reg_date);
-    clients_.emplace(id, client);
-    return client;
+    return *client;
 }
 
-bool ClubSystem::sell_product(int product_id, int quantity) {
-    auto it = products_.find(product_id);
-    if(it == products_.end() || !it->second.sell(quantity)) return false;
+bool ClubSystem::sell_product(int product_id, int quantity, int client_id) {
+    if(client_id > 0) {
+        if(!clients_complete_) fault_in_client(client_id);
+        if(!std::atomic_load(&clients_)->find(client_id)) return false;
+    }
+    const auto snapshot = products();
+    const Product* product = snapshot->find(product_id);
+    if(!product || !stock_.reserve(product_id, quantity)) return false;
 
+    // В БД продажа и списание попадают порцией из журнала, без ожидания записи
     try {
-        DatabaseManager::instance().execute(
-            "UPDATE products SET stock = ? WHERE id = ?",
-            {std::to_string(it->second.stock()), std::to_string(product_id)}
-        );
-        return true;
+        sales_.record({product_id, client_id, quantity,
+                       product->price() * quantity, std::time(nullptr)});
     } catch(...) {
-        it->second.restock(quantity);
+        stock_.release(product_id, quantity);
         return false;
     }
+    stock_.commit(product_id, quantity);
+    return true;
+}
+
+std::future<bool> ClubSystem::sell_product_async(int product_id, int quantity, int client_id) {
+    return DatabaseManager::instance().run_async([this, product_id, quantity, client_id] {
+        return sell_product(product_id, quantity, client_id);
+    });
+}
+
+int ClubSystem::product_stock(int product_id) const noexcept {
+    const std::shared_future<void> loading = data_loading_;
+    if(loading.valid()) loading.wait();
+    return stock_.on_hand(product_id);
 }
 
 bool ClubSystem::update_client(int client_id, const std::string& new_contact) {
-    auto it = clients_.find(client_id);
-    if(it == clients_.end()) return false;
+    if(!clients_complete_) fault_in_client(client_id);
+    DatabaseManager::WriteTicket ticket;
+    uint64_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        const Client* client = std::atomic_load(&clients_)->find(client_id);
+        if(!client) return false;
+        try {
+            Client(*client).update_contact(new_contact);
+            ticket = DatabaseManager::instance().submit(
+                "UPDATE clients SET contact = ? WHERE id = ?",
+                {new_contact, client_id}
+            );
+        } catch(...) {
+            return false;
+        }
+        sequence = begin_write();
+    }
 
+    // Память меняется только после фиксации: при групповой записи ошибка
+    // (например, занятый контакт) приходит через билет
+    bool committed = true;
     try {
-        DatabaseManager::instance().execute(
-            "UPDATE clients SET contact = ? WHERE id = ?",
-            {new_contact, std::to_string(client_id)}
-        );
-        it->second.update_contact(new_contact);
-        return true;
+        ticket.get();
     } catch(...) {
-        return false;
+        committed = false;
     }
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if(!finish_write(client_versions_, client_id, sequence, committed)) return committed;
+    const auto current = std::atomic_load(&clients_);
+    const Client* client = current->find(client_id);
+    if(!client) return true;
+    auto updated = std::make_shared<Client>(*client);
+    updated->update_contact(new_contact);
+    auto next = std::make_shared<ClientMap>(*current);
+    next->insert_or_assign(client_id, std::shared_ptr<const Client>(updated));
+    publish(clients_, std::move(next));
+
+    std::unique_lock<std::shared_mutex> index_lock(client_index_mutex_);
+    client_index_.add(client_id, {updated->name(), updated->contact()});
+    return true;
+}
+
+// Вызывается под write_mutex_ сразу после постановки изменения в очередь
+uint64_t ClubSystem::begin_write() {
+    ++writes_in_flight_;
+    return ++write_sequence_;
+}
+
+// Вызывается под write_mutex_ после завершения билета. Возвращает, нужно ли
+// применить изменение к памяти: оно зафиксировано и новее уже применённого.
+bool ClubSystem::finish_write(std::unordered_map<int, uint64_t>& versions, int id,
+                              uint64_t sequence, bool committed) {
+    if(--writes_in_flight_ == 0) writes_applied_cv_.notify_all();
+    if(!committed) return false;
+    uint64_t& applied = versions[id];
+    if(applied > sequence) return false;
+    applied = sequence;
+    return true;
 }
 
+// Остатки здесь не пишутся: в БД их меняет только журнал продаж, в одной
+// транзакции со строками sales. Незаписанные продажи не должны уменьшить
+// остаток без строки о продаже.
 void ClubSystem::save_data() {
     auto& db = DatabaseManager::instance();
-    try {
-        db.begin_transaction();
-        
-        for(const auto& [id, client] : clients_) {
+    const auto client_snapshot = clients();
+    db.transaction([&] {
+        for(const auto& client : *client_snapshot) {
             db.execute(
                 "UPDATE clients SET name = ?, contact = ? WHERE id = ?",
-                {client.name(), client.contact(), std::to_string(id)}
-            );
-        }
-        
-        for(const auto& [id, product] : products_) {
-            db.execute(
-                "UPDATE products SET stock = ? WHERE id = ?",
-                {std::to_string(product.stock()), std::to_string(id)}
+                {client.name(), client.contact(), client.id()}
             );
         }
-        
-        db.commit_transaction();
-    } catch(...) {
-        db.rollback_transaction();
-        throw;
-    }
+    });
 }
 
 void ClubSystem::shutdown() {
+    if(data_loading_.valid()) data_loading_.wait();
+    DatabaseManager::instance().wait_async();
+    stop_snapshot_timer();
+    try {
+        sales_.stop();
+    } catch(const std::exception& error) {
+        // Незаписанные продажи теряются; остаток в БД, как и таблица sales,
+        // их не учитывает
+        std::cerr << "Не удалось записать журнал продаж: " << error.what() << "\n";
+    }
     save_data();
+    try {
+        save_snapshot();
+    } catch(...) {
+        // Без снимка следующий запуск загрузит данные из БД
+    }
     DatabaseManager::instance().disconnect();
 }
 
+int64_t ClubSystem::data_generation() const {
+    auto rows = DatabaseManager::instance().fetch_all(
+        "SELECT value FROM meta WHERE key = 'generation'"
+    );
+    return rows.empty() ? -1 : rows[0].get_int64(0);
+}
+
+bool ClubSystem::load_snapshot() {
+    if(snapshot_path_.empty()) return false;
+
+    const int64_t generation = data_generation();
+    std::optional<StateSnapshot::Contents> contents;
+    try {
+        contents = StateSnapshot::read(snapshot_path_, generation);
+    } catch(const std::exception&) {
+        return false;
+    }
+    if(!contents) return false;
+
+    auto seats = std::make_shared<SeatMap>(std::move(contents->seats));
+    auto clients = std::make_shared<ClientMap>(std::move(contents->clients));
+    auto products = std::make_shared<ProductMap>(std::move(contents->products));
+
+    build_client_indexes(*clients);
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        track_stock(*products);
+        publish(seats_, std::move(seats));
+        publish(clients_, std::move(clients));
+        publish(products_, std::move(products));
+    }
+
+    std::lock_guard<std::mutex> snapshot_lock(snapshot_mutex_);
+    snapshot_generation_ = generation;
+    return true;
+}
+
+void ClubSystem::save_snapshot() {
+    if(snapshot_path_.empty() || !DatabaseManager::instance().is_connected()) return;
+
+    wait_for_clients();
+    wait_for_data();
+    std::lock_guard<std::mutex> snapshot_lock(snapshot_mutex_);
+    int64_t generation;
+    SeatSnapshot seat_snapshot;
+    ClientSnapshot client_snapshot;
+    ProductMap product_snapshot;
+    {
+        // Под write_mutex_, когда зафиксированные изменения применены к памяти,
+        // номер поколения и снимки согласованы: чтение из БД дописывает
+        // очередь групповой фиксации, новых изменений нет.
+        // Остатки меняет и журнал продаж без write_mutex_, поэтому они
+        // читаются из БД в одной транзакции с номером поколения.
+        std::unique_lock<std::mutex> lock(write_mutex_);
+        writes_applied_cv_.wait(lock, [this] { return writes_in_flight_ == 0; });
+        seat_snapshot = seats();
+        client_snapshot = std::atomic_load(&clients_);
+        const auto products = this->products();
+        auto& db = DatabaseManager::instance();
+        ProductMap::Builder stocked;
+        db.transaction([&] {
+            generation = data_generation();
+            db.for_each_row("SELECT id, stock FROM products", {},
+                [&](const DatabaseManager::Row& row) {
+                    const Product* product = products->find(row.get_int(0));
+                    if(!product) return;
+                    stocked.insert_or_assign(product->id(), Product(
+                        product->id(), product->name(), product->category(),
+                        product->price(), row.get_int(1)));
+                });
+        });
+        product_snapshot = stocked.build();
+    }
+    if(generation < 0 || generation == snapshot_generation_) return;
+
+    StateSnapshot::write(snapshot_path_, generation,
+                         *seat_snapshot, *client_snapshot, product_snapshot);
+    snapshot_generation_ = generation;
+}
+
+void ClubSystem::set_snapshot_interval(std::chrono::seconds interval) {
+    {
+        std::lock_guard<std::mutex> lock(snapshot_timer_mutex_);
+        snapshot_interval_ = interval;
+    }
+    snapshot_timer_cv_.notify_all();
+}
+
+void ClubSystem::start_snapshot_timer() {
+    stop_snapshot_timer();
+    {
+        std::lock_guard<std::mutex> lock(snapshot_timer_mutex_);
+        stop_snapshots_ = false;
+    }
+    snapshot_thread_ = std::thread([this] {
+        std::unique_lock<std::mutex> lock(snapshot_timer_mutex_);
+        while(!stop_snapshots_) {
+            const auto deadline = std::chrono::steady_clock::now() + snapshot_interval_;
+            if(snapshot_timer_cv_.wait_until(lock, deadline, [this] { return stop_snapshots_; })) {
+                break;
+            }
+            if(std::chrono::steady_clock::now() < deadline) continue;
+
+            lock.unlock();
+            try {
+                save_snapshot();
+            } catch(...) {
+                // Повторная попытка на следующем срабатывании таймера
+            }
+            lock.lock();
+        }
+    });
+}
+
+void ClubSystem::stop_snapshot_timer() {
+    {
+        std::lock_guard<std::mutex> lock(snapshot_timer_mutex_);
+        stop_snapshots_ = true;
+    }
+    snapshot_timer_cv_.notify_all();
+    if(snapshot_thread_.joinable()) snapshot_thread_.join();
+}
+
 ReservationManager& ClubSystem::reservations() { 
+    wait_for_data();
     return *reservation_manager_; 
 }
 
-const std::vector<Seat>& ClubSystem::seats() const noexcept {
-    return seats_;
+const SalesLedger& ClubSystem::sales() const {
+    wait_for_data();
+    return sales_;
 }
 
-const Client& ClubSystem::get_client(int client_id) const {
-    auto it = clients_.find(client_id);
-    if(it == clients_.end()) throw std::runtime_error("Client not found");
-    return it->second;
+ClubSystem::ProductSnapshot ClubSystem::products() const {
+    wait_for_data();
+    return std::atomic_load(&products_);
+}
+
+ClubSystem::SeatSnapshot ClubSystem::seats() const {
+    return std::atomic_load(&seats_);
+}
+
+ClubSystem::ClientSnapshot ClubSystem::clients() const {
+    wait_for_clients();
+    return std::atomic_load(&clients_);
+}
+
+Client ClubSystem::get_client(int client_id) const {
+    const auto snapshot = std::atomic_load(&clients_);
+    if(const Client* client = snapshot->find(client_id)) return *client;
+
+    if(!clients_complete_) {
+        if(auto loaded = fault_in_client(client_id)) return *loaded;
+    }
+    throw std::runtime_error("Client not found");
 }
 
-const Seat& ClubSystem::get_seat(int seat_id) const {
-    auto it = std::find_if(seats_.begin(), seats_.end(),
-        [seat_id](const Seat& s) { return s.id() == seat_id; });
-    if(it == seats_.end()) throw std::runtime_error("Seat not found");
-    return *it;
+Seat ClubSystem::get_seat(int seat_id) const {
+    const auto snapshot = seats();
+    const Seat* seat = snapshot->find(seat_id);
+    if(!seat) throw std::runtime_error("Seat not found");
+    return *seat;
 }
 
 std::vector<Product> ClubSystem::get_products() const {
-    std::vector<Product> result;
-    for(const auto& [id, product] : products_) {
-        result.push_back(product);
+    return current_products(*products());
+}
+
+std::vector<Client> ClubSystem::find_clients(const std::string& query) const {
+    wait_for_clients();
+    std::vector<int> ids;
+    {
+        std::shared_lock<std::shared_mutex> lock(client_index_mutex_);
+        ids = client_index_.search(query);
+    }
+
+    const auto snapshot = clients();
+    std::vector<Client> result;
+    result.reserve(ids.size());
+    for(int id : ids) {
+        if(const Client* client = snapshot->find(id)) {
+            result.push_back(*client);
+        }
     }
     return result;
 }
 
-std::vector<Client> ClubSystem::find_clients(const std::string& query) const {
-    std::string lower_query;
-    std::transform(query.begin(), query.end(), std::back_inserter(lower_query),
-        [](unsigned char c){ return std::tolower(c); });
-    
+std::vector<Client> ClubSystem::find_clients_fuzzy(const std::string& query,
+                                               int max_edits,
+                                               size_t limit) const {
+    wait_for_clients();
+    std::vector<FuzzyNameIndex::Match> matches;
+    {
+        std::shared_lock<std::shared_mutex> lock(client_index_mutex_);
+        matches = client_names_.search(query, std::max(max_edits, 0), limit);
+    }
+
+    const auto snapshot = clients();
     std::vector<Client> result;
-    for(const auto& [id, client] : clients_) {
-        std::string name_lower = client.name();
-        std::transform(name_lower.begin(), name_lower.end(), name_lower.begin(), ::tolower);
-        
-        std::string contact_lower = client.contact();
-        std::transform(contact_lower.begin(), contact_lower.end(), contact_lower.begin(), ::tolower);
-        
-        if(name_lower.find(lower_query) != std::string::npos || 
-           contact_lower.find(lower_query) != std::string::npos) {
-            result.push_back(client);
+    result.reserve(matches.size());
+    for(const auto& match : matches) {
+        if(const Client* client = snapshot->find(match.id)) {
+            result.push_back(*client);
         }
     }
     return result;
 }
 
 void ClubSystem::add_product(const Product& product) {
-    auto& db = DatabaseManager::instance();
+    wait_for_data();
+    std::lock_guard<std::mutex> lock(write_mutex_);
     
-    db.execute(
+    const int id = static_cast<int>(DatabaseManager::instance().insert(
         "INSERT INTO products (name, category, price, stock) VALUES (?, ?, ?, ?)",
         {
             product.name(),
-            std::to_string(static_cast<int>(product.category())),
-            std::to_string(product.price()),
-            std::to_string(product.stock())
+            static_cast<int>(product.category()),
+            product.price(),
+            product.stock()
         }
-    );
+    ));
     
-    load_products();
+    auto next = std::make_shared<ProductMap>(*std::atomic_load(&products_));
+    next->insert_or_assign(id, Product(
+        id,
+        product.name(),
+        product.category(),
+        product.price(),
+        product.stock()
+    ));
+    stock_.set(id, product.stock());
+    publish(products_, std::move(next));
 }
 
 void ClubSystem::update_seat_status(int seat_id, Seat::Status new_status) {
-    auto it = std::find_if(seats_.begin(), seats_.end(),
-        [seat_id](const Seat& s) { return s.id() == seat_id; });
-    
-    if(it == seats_.end()) {
-        throw std::runtime_error("Место не найдено");
+    DatabaseManager::WriteTicket ticket;
+    uint64_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        if(!std::atomic_load(&seats_)->find(seat_id)) {
+            throw std::runtime_error("Место не найдено");
+        }
+
+        ticket = DatabaseManager::instance().submit(
+            "UPDATE seats SET status = ? WHERE id = ?",
+            {
+                static_cast<int>(new_status),
+                seat_id
+            }
+        );
+        sequence = begin_write();
     }
-    
-    DatabaseManager::instance().execute(
-        "UPDATE seats SET status = ? WHERE id = ?",
-        {
-            std::to_string(static_cast<int>(new_status)),
-            std::to_string(seat_id)
+
+    try {
+        ticket.get();
+    } catch(...) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        finish_write(seat_versions_, seat_id, sequence, false);
+        throw;
+    }
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if(!finish_write(seat_versions_, seat_id, sequence, true)) return;
+    const auto current = std::atomic_load(&seats_);
+    const Seat* seat = current->find(seat_id);
+    if(!seat) return;
+    Seat updated = *seat;
+    updated.set_status(new_status);
+    auto next = std::make_shared<SeatMap>(*current);
+    next->insert_or_assign(seat_id, std::move(updated));
+    publish(seats_, std::move(next));
+}
+
+std::future<void> ClubSystem::update_seat_status_async(int seat_id, Seat::Status new_status) {
+    return DatabaseManager::instance().run_async([this, seat_id, new_status] {
+        update_seat_status(seat_id, new_status);
+    });
+}
+
+ClubSystem::ImportReport ClubSystem::import_clients(std::istream& csv) {
+    wait_for_clients();
+    std::lock_guard<std::mutex> lock(write_mutex_);
+
+    std::unordered_set<std::string> contacts;
+    const auto current = std::atomic_load(&clients_);
+    contacts.reserve(current->size());
+    for(const auto& client : *current) contacts.insert(client.contact());
+
+    const time_t now = time(nullptr);
+    std::vector<std::shared_ptr<const Client>> imported;
+
+    ImportPlan<ParsedClient> plan;
+    plan.header = "name";
+    plan.insert_prefix = "INSERT INTO clients (name, contact, reg_date) VALUES ";
+    plan.row_placeholders = "(?, ?, ?)";
+    plan.rows_per_insert = 256;
+    plan.validate = [now](const CsvReader::Record& record, ParsedClient& client, std::string& error) {
+        const auto& fields = record.fields;
+        if(fields.size() < 2 || fields.size() > 3) {
+            error = "Ожидается 2-3 поля: name,contact[,reg_date]";
+            return false;
         }
-    );
-    
-    load_seats();
-}
\ No newline at end of file
+        client.name = std::string(trim(fields[0]));
+        client.contact = std::string(trim(fields[1]));
+        if(client.name.empty()) {
+            error = "Пустое имя";
+            return false;
+        }
+        if(!Client::is_phone(client.contact) && !Client::is_email(client.contact)) {
+            error = "Неверный формат контакта: " + client.contact;
+            return false;
+        }
+        client.registered = now;
+        if(fields.size() == 3 && !trim(fields[2]).empty()) {
+            int64_t registered = 0;
+            if(!parse_number(fields[2], registered) || registered < 0) {
+                error = "Неверная дата регистрации: " + fields[2];
+                return false;
+            }
+            client.registered = static_cast<time_t>(registered);
+        }
+        return true;
+    };
+    plan.accept = [&contacts](const ParsedClient& client, std::string& error) {
+        if(!contacts.insert(client.contact).second) {
+            error = "Контакт уже зарегистрирован: " + client.contact;
+            return false;
+        }
+        return true;
+    };
+    plan.bind = [](const ParsedClient& client, std::vector<DatabaseManager::Value>& params) {
+        params.emplace_back(client.name);
+        params.emplace_back(client.contact);
+        params.emplace_back(static_cast<long long>(client.registered));
+    };
+    plan.committed = [&imported](int id, ParsedClient&& client) {
+        imported.push_back(std::make_shared<const Client>(
+            Client::trusted, id, std::move(client.name), std::move(client.contact), client.registered));
+    };
+
+    // Зафиксированные порции попадают в память и при ошибке следующих
+    const auto apply = [this, &imported] {
+        if(imported.empty()) return;
+        ClientMap::Builder next(*std::atomic_load(&clients_));
+        for(const auto& client : imported) next.insert_or_assign(client->id(), client);
+        publish(clients_, std::make_shared<ClientMap>(next.build()));
+
+        std::unique_lock<std::shared_mutex> index_lock(client_index_mutex_);
+        for(const auto& client : imported) {
+            client_index_.add(client->id(), {client->name(), client->contact()});
+            client_names_.add(client->id(), client->name());
+        }
+    };
+
+    ImportReport report;
+    try {
+        report = run_import(csv, plan);
+    } catch(...) {
+        apply();
+        throw;
+    }
+    apply();
+    return report;
+}
+
+ClubSystem::ImportReport ClubSystem::import_products(std::istream& csv) {
+    wait_for_data();
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    std::vector<Product> imported;
+
+    ImportPlan<ParsedProduct> plan;
+    plan.header = "name";
+    plan.insert_prefix = "INSERT INTO products (name, category, price, stock) VALUES ";
+    plan.row_placeholders = "(?, ?, ?, ?)";
+    plan.rows_per_insert = 200;
+    plan.validate = [](const CsvReader::Record& record, ParsedProduct& product, std::string& error) {
+        static const char* const categories[] = {"food", "drink", "accessory", "service"};
+
+        const auto& fields = record.fields;
+        if(fields.size() != 4) {
+            error = "Ожидается 4 поля: name,category,price,stock";
+            return false;
+        }
+        product.name = std::string(trim(fields[0]));
+        if(product.name.empty()) {
+            error = "Пустое название";
+            return false;
+        }
+
+        int category = -1;
+        if(!parse_number(fields[1], category)) {
+            for(int i = 0; i <= static_cast<int>(Product::Category::Service); ++i) {
+                if(equals_ascii_nocase(trim(fields[1]), categories[i])) category = i;
+            }
+        }
+        if(category < 0 || category > static_cast<int>(Product::Category::Service)) {
+            error = "Неизвестная категория: " + fields[1];
+            return false;
+        }
+        product.category = static_cast<Product::Category>(category);
+
+        if(!parse_price(fields[2], product.price) || product.price <= 0) {
+            error = "Неверная цена: " + fields[2];
+            return false;
+        }
+        if(!parse_number(fields[3], product.stock) || product.stock < 0) {
+            error = "Неверное количество: " + fields[3];
+            return false;
+        }
+        return true;
+    };
+    plan.accept = [](const ParsedProduct&, std::string&) { return true; };
+    plan.bind = [](const ParsedProduct& product, std::vector<DatabaseManager::Value>& params) {
+        params.emplace_back(product.name);
+        params.emplace_back(static_cast<int>(product.category));
+        params.emplace_back(product.price);
+        params.emplace_back(product.stock);
+    };
+    plan.committed = [&imported](int id, ParsedProduct&& product) {
+        imported.emplace_back(id, std::move(product.name), product.category,
+                              product.price, product.stock);
+    };
+
+    const auto apply = [this, &imported] {
+        if(imported.empty()) return;
+        ProductMap::Builder next(*std::atomic_load(&products_));
+        for(auto& product : imported) {
+            stock_.set(product.id(), product.stock());
+            next.insert_or_assign(product.id(), std::move(product));
+        }
+        publish(products_, std::make_shared<ProductMap>(next.build()));
+    };
+
+    ImportReport report;
+    try {
+        report = run_import(csv, plan);
+    } catch(...) {
+        apply();
+        throw;
+    }
+    apply();
+    return report;
+}
@@ -0,0 +1,90 @@
+#include "../../include/core/CsvReader.h"
+
+CsvReader::CsvReader(std::istream& in, char delimiter)
+    : in_(in), delimiter_(delimiter) {}
+
+bool CsvReader::read_chunk(size_t max_records, std::vector<Record>& out) {
+    for(size_t i = 0; i < max_records; ++i) {
+        Record record;
+        if(!read_record(record)) return false;
+        out.push_back(std::move(record));
+    }
+    return true;
+}
+
+int CsvReader::get() {
+    if(pending_.empty()) return in_.get();
+    const int c = static_cast<unsigned char>(pending_.front());
+    pending_.erase(0, 1);
+    return c;
+}
+
+int CsvReader::peek() {
+    return pending_.empty() ? in_.peek() : static_cast<unsigned char>(pending_.front());
+}
+
+// UTF-8 BOM, который добавляют табличные редакторы. Байты читаются по одному
+// после сравнения с peek; при несовпадении уже прочитанные отдаются первыми.
+void CsvReader::skip_bom() {
+    for(const char expected : {'\xEF', '\xBB', '\xBF'}) {
+        if(in_.peek() != static_cast<unsigned char>(expected)) return;
+        pending_.push_back(static_cast<char>(in_.get()));
+    }
+    pending_.clear();
+}
+
+bool CsvReader::read_record(Record& record) {
+    if(first_) {
+        first_ = false;
+        skip_bom();
+    }
+
+    // Пустые строки между записями пропускаются
+    int c = get();
+    while(c == '\n' || c == '\r') {
+        if(c == '\n') ++line_;
+        c = get();
+    }
+    if(c == std::char_traits<char>::eof()) return false;
+
+    record.line = line_;
+    record.fields.clear();
+    record.error.clear();
+    std::string field;
+    bool quoted = false;
+
+    while(true) {
+        if(quoted) {
+            if(c == std::char_traits<char>::eof()) {
+                record.fields.push_back(std::move(field));
+                record.error = "Незакрытая кавычка в конце файла";
+                return true;
+            }
+            if(c == '"') {
+                if(peek() == '"') {
+                    field.push_back('"');
+                    get();
+                } else {
+                    quoted = false;
+                }
+            } else {
+                if(c == '\n') ++line_;
+                field.push_back(static_cast<char>(c));
+            }
+        } else if(c == '"' && field.empty()) {
+            quoted = true;
+        } else if(c == delimiter_) {
+            record.fields.push_back(std::move(field));
+            field.clear();
+        } else if(c == '\r' && peek() == '\n') {
+            // \r\n обрабатывается на следующем символе
+        } else if(c == '\n' || c == std::char_traits<char>::eof()) {
+            if(c == '\n') ++line_;
+            record.fields.push_back(std::move(field));
+            return true;
+        } else {
+            field.push_back(static_cast<char>(c));
+        }
+        c = get();
+    }
+}
@@ -1,5 +1,31 @@
 #include "../../include/core/DatabaseManager.h"
 
+namespace {
+
+// Менеджер, чьим фоновым потоком задач является текущий поток
+thread_local const DatabaseManager* writer_thread_of = nullptr;
+
+// Закрывает читающее соединение потока, когда поток завершается: короткие
+// потоки (std::async при импорте, сканы аналитики) не копят соединения
+struct ReaderRelease {
+    DatabaseManager* manager = nullptr;
+
+    ~ReaderRelease() {
+        if(manager) manager->release_reader();
+    }
+};
+thread_local ReaderRelease reader_release;
+
+// Ожидание блокировки с опросом раз в миллисекунду. Стандартный обработчик
+// busy_timeout засыпает всё дольше (до 100 мс), и интерактивный запрос
+// просыпается намного позже, чем фоновая транзакция освобождает БД.
+int poll_busy(void* timeout_ms, int count) {
+    if(count >= static_cast<int>(reinterpret_cast<intptr_t>(timeout_ms))) return 0;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return 1;
+}
+
+}
 
 DatabaseManager& DatabaseManager::instance() {
     static DatabaseManager instance;
@@ -11,82 +37,494 @@ DatabaseManager::~DatabaseManager() {
 }
 
 void DatabaseManager::disconnect() {
+    // Поставленные асинхронные задачи выполняются до закрытия соединения
+    stop_writer();
+    writer_statements_.clear();
+    if(writer_db_) {
+        sqlite3_close(writer_db_);
+        writer_db_ = nullptr;
+    }
+    stop_flusher();
+
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    close_readers();
     if(db_) {
+        drain_pending();
+        statements_.clear();
         sqlite3_close(db_);
         db_ = nullptr;
     }
+    std::lock_guard<std::mutex> queue_lock(queue_mutex_);
+    group_commit_.enabled = false;
 }
 
 void DatabaseManager::connect(const std::string& dbPath) {
-    if(db_) disconnect();
-    sqlite3* connection;
-    if(sqlite3_open(dbPath.c_str(), &connection) != SQLITE_OK) {
-        throw std::runtime_error(sqlite3_errmsg(connection));
+    connect(dbPath, StorageProfile());
+}
+
+void DatabaseManager::connect(const std::string& dbPath, const StorageProfile& profile) {
+    if(is_connected()) disconnect();
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    sqlite3* connection = open_writer(dbPath, profile);
+    sqlite3* writer_connection;
+    try {
+        writer_connection = open_writer(dbPath, profile);
+    } catch(...) {
+        sqlite3_close(connection);
+        throw;
     }
     db_ = connection;
-    execute("PRAGMA foreign_keys = ON");
+    profile_ = profile;
+    {
+        std::lock_guard<std::mutex> readers_lock(readers_mutex_);
+        db_path_ = dbPath;
+    }
+    statements_.attach(db_);
+    writer_db_ = writer_connection;
+    writer_statements_.attach(writer_db_);
+    start_writer();
+}
+
+sqlite3* DatabaseManager::open_writer(const std::string& path, const StorageProfile& profile) {
+    sqlite3* connection;
+    if(sqlite3_open(path.c_str(), &connection) != SQLITE_OK) {
+        std::string error = sqlite3_errmsg(connection);
+        sqlite3_close(connection);
+        throw std::runtime_error(error);
+    }
+    try {
+        if(sqlite3_exec(connection, "PRAGMA foreign_keys = ON", nullptr, nullptr, nullptr) != SQLITE_OK) {
+            throw std::runtime_error(sqlite3_errmsg(connection));
+        }
+        apply_profile(connection, profile, true);
+    } catch(...) {
+        sqlite3_close(connection);
+        throw;
+    }
+    return connection;
+}
+
+void DatabaseManager::apply_profile(sqlite3* db, const StorageProfile& profile, bool writer) {
+    // Значения PRAGMA не параметризуются, поэтому подставляются в текст
+    std::vector<std::string> pragmas;
+    if(writer) {
+        pragmas.push_back("PRAGMA journal_mode = " + profile.journal_mode);
+        pragmas.push_back("PRAGMA synchronous = " + profile.synchronous);
+    }
+    pragmas.push_back("PRAGMA mmap_size = " + std::to_string(profile.mmap_size));
+    pragmas.push_back("PRAGMA cache_size = " + std::to_string(profile.cache_size));
+
+    for(const auto& pragma : pragmas) {
+        if(sqlite3_exec(db, pragma.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+            throw std::runtime_error(sqlite3_errmsg(db));
+        }
+    }
+    sqlite3_busy_handler(db, poll_busy, reinterpret_cast<void*>(static_cast<intptr_t>(profile.busy_timeout_ms)));
+}
+
+bool DatabaseManager::is_connected() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return db_ != nullptr;
 }
 
 void DatabaseManager::check_connection() const {
     if(!db_) throw std::runtime_error("Database not connected");
 }
 
-sqlite3_stmt* DatabaseManager::prepare_statement(const std::string& query) {
-    check_connection();
+sqlite3_stmt* DatabaseManager::prepare_statement(sqlite3* db, const std::string& query) {
+    if(!db) throw std::runtime_error("Database not connected");
     sqlite3_stmt* stmt;
-    if(sqlite3_prepare_v2(db_, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        throw std::runtime_error(sqlite3_errmsg(db_));
+    if(sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        throw Error(sqlite3_errmsg(db), sqlite3_extended_errcode(db));
     }
     return stmt;
 }
 
-void DatabaseManager::execute(const std::string& query) {
-    sqlite3_stmt* stmt = prepare_statement(query);
-    if(sqlite3_step(stmt) != SQLITE_DONE) {
-        sqlite3_finalize(stmt);
-        throw std::runtime_error("Failed to execute query");
+DatabaseManager::Statement::Statement(sqlite3_stmt* stmt, CachedStatement* entry)
+    : stmt_(stmt), entry_(entry) {}
+
+DatabaseManager::Statement::~Statement() {
+    if(entry_) {
+        sqlite3_reset(stmt_);
+        sqlite3_clear_bindings(stmt_);
+        entry_->in_use = false;
+    } else {
+        sqlite3_finalize(stmt_);
+    }
+}
+
+DatabaseManager::StatementCache::~StatementCache() {
+    clear();
+}
+
+void DatabaseManager::StatementCache::attach(sqlite3* db) {
+    clear();
+    db_ = db;
+}
+
+DatabaseManager::Statement DatabaseManager::StatementCache::acquire(const std::string& query) {
+    auto found = index_.find(query);
+    if(found != index_.end()) {
+        auto entry = found->second;
+        if(!entry->in_use) {
+            ++hits_;
+            lru_.splice(lru_.begin(), lru_, entry);
+            entry->in_use = true;
+            return Statement(entry->stmt, &*entry);
+        }
+        // Тот же запрос уже выполняется выше по стеку - компилируем временную копию
+        ++misses_;
+        return Statement(prepare_statement(db_, query), nullptr);
+    }
+
+    ++misses_;
+    sqlite3_stmt* stmt = prepare_statement(db_, query);
+    if(capacity_ == 0) {
+        return Statement(stmt, nullptr);
+    }
+
+    evict(capacity_ - 1);
+    if(lru_.size() >= capacity_) {
+        return Statement(stmt, nullptr);
+    }
+
+    lru_.push_front({query, stmt, true});
+    index_.emplace(query, lru_.begin());
+    return Statement(stmt, &lru_.front());
+}
+
+void DatabaseManager::StatementCache::evict(size_t capacity) {
+    auto it = lru_.end();
+    while(lru_.size() > capacity && it != lru_.begin()) {
+        --it;
+        if(it->in_use) continue;
+        sqlite3_finalize(it->stmt);
+        index_.erase(it->sql);
+        it = lru_.erase(it);
+    }
+}
+
+void DatabaseManager::StatementCache::clear() {
+    for(auto& entry : lru_) {
+        sqlite3_finalize(entry.stmt);
+    }
+    lru_.clear();
+    index_.clear();
+    db_ = nullptr;
+}
+
+void DatabaseManager::StatementCache::set_capacity(size_t capacity) {
+    capacity_ = capacity;
+    evict(capacity);
+}
+
+void DatabaseManager::set_statement_cache_capacity(size_t capacity) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    statements_.set_capacity(capacity);
+}
+
+size_t DatabaseManager::statement_cache_hits() const noexcept {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return statements_.hits();
+}
+
+size_t DatabaseManager::statement_cache_misses() const noexcept {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return statements_.misses();
+}
+
+DatabaseManager::SharedCall::SharedCall(DatabaseManager& manager) : manager_(manager) {
+    ++manager_.shared_calls_;
+    lock_ = std::unique_lock<std::recursive_mutex>(manager_.mutex_);
+}
+
+DatabaseManager::SharedCall::~SharedCall() {
+    lock_.unlock();
+    if(--manager_.shared_calls_ == 0) {
+        std::lock_guard<std::mutex> lock(manager_.shared_calls_mutex_);
+        manager_.shared_calls_cv_.notify_all();
     }
-    sqlite3_finalize(stmt);
 }
 
-void DatabaseManager::execute(const std::string& query, const std::vector<std::string>& params) {
-    sqlite3_stmt* stmt = prepare_statement(query);
-    
+DatabaseManager::Session::Session(DatabaseManager& manager) {
+    if(writer_thread_of == &manager) {
+        // Внутри своей транзакции фоновый поток никого не ждёт: он держит
+        // блокировку записи, и ожидающий её вызов ждал бы его самого.
+        // Очередь пишет общее соединение, поэтому и её здесь не дописываем.
+        if(sqlite3_get_autocommit(manager.writer_db_)) {
+            std::unique_lock<std::mutex> lock(manager.shared_calls_mutex_);
+            manager.shared_calls_cv_.wait(lock, [&manager] { return manager.shared_calls_ == 0; });
+            lock.unlock();
+            if(manager.pending_count_.load() > 0) manager.flush();
+        }
+        db_ = manager.writer_db_;
+        statements_ = &manager.writer_statements_;
+    } else {
+        shared_.emplace(manager);
+        manager.drain_pending();
+        db_ = manager.db_;
+        statements_ = &manager.statements_;
+    }
+}
+
+void DatabaseManager::execute(const std::string& query) {
+    Session session(*this);
+    run(session.db(), session.statements(), query, {});
+}
+
+void DatabaseManager::bind_params(sqlite3* db, sqlite3_stmt* stmt, const std::vector<Value>& params) {
     for(size_t i = 0; i < params.size(); ++i) {
-        sqlite3_bind_text(stmt, i+1, params[i].c_str(), -1, SQLITE_TRANSIENT);
+        const int index = static_cast<int>(i) + 1;
+        const Value& value = params[i];
+        int rc = SQLITE_OK;
+        switch(value.type()) {
+            case Value::Type::Null:
+                rc = sqlite3_bind_null(stmt, index);
+                break;
+            case Value::Type::Integer:
+                rc = sqlite3_bind_int64(stmt, index, value.integer());
+                break;
+            case Value::Type::Real:
+                rc = sqlite3_bind_double(stmt, index, value.real());
+                break;
+            case Value::Type::Text:
+                // Строка живёт до конца вызова, а запрос сбрасывает привязки при возврате в кэш
+                rc = sqlite3_bind_text(stmt, index, value.text().data(),
+                                       static_cast<int>(value.text().size()), SQLITE_STATIC);
+                break;
+        }
+        if(rc != SQLITE_OK) {
+            throw Error(sqlite3_errmsg(db), sqlite3_extended_errcode(db));
+        }
     }
-    
-    if(sqlite3_step(stmt) != SQLITE_DONE) {
-        sqlite3_finalize(stmt);
-        throw std::runtime_error("Failed to execute query with parameters");
+}
+
+void DatabaseManager::execute(const std::string& query, const std::vector<Value>& params) {
+    Session session(*this);
+    run(session.db(), session.statements(), query, params);
+}
+
+void DatabaseManager::run(const std::string& query, const std::vector<Value>& params) {
+    run(db_, statements_, query, params);
+}
+
+void DatabaseManager::run(sqlite3* db, StatementCache& statements,
+                          const std::string& query, const std::vector<Value>& params) {
+    if(!db) throw std::runtime_error("Database not connected");
+    Statement stmt = statements.acquire(query);
+    bind_params(db, stmt.get(), params);
+
+    if(sqlite3_step(stmt.get()) != SQLITE_DONE) {
+        throw Error(std::string(params.empty()
+            ? "Failed to execute query: "
+            : "Failed to execute query with parameters: ") + sqlite3_errmsg(db),
+            sqlite3_extended_errcode(db));
     }
-    sqlite3_finalize(stmt);
 }
 
-std::vector<DatabaseManager::ResultRow> DatabaseManager::fetch_all(const std::string& query, 
-                                                                 const std::vector<std::string>& params) {
+std::vector<DatabaseManager::ResultRow> DatabaseManager::fetch_all(const std::string& query,
+                                                                 const std::vector<Value>& params) {
     std::vector<ResultRow> result;
-    sqlite3_stmt* stmt = prepare_statement(query);
-    
-    for(size_t i = 0; i < params.size(); ++i) {
-        sqlite3_bind_text(stmt, i+1, params[i].c_str(), -1, SQLITE_TRANSIENT);
+    for_each_row(query, params, [&result](const Row& row) {
+        result.emplace_back(row);
+    });
+    return result;
+}
+
+void DatabaseManager::for_each_row(const std::string& query,
+                                   const std::vector<Value>& params,
+                                   const RowVisitor& fn) {
+    Session session(*this);
+    if(!session.db()) throw std::runtime_error("Database not connected");
+    Statement stmt = session.statements().acquire(query);
+    bind_params(session.db(), stmt.get(), params);
+    step_rows(session.db(), stmt.get(), fn);
+}
+
+void DatabaseManager::step_rows(sqlite3* db, sqlite3_stmt* stmt,
+                                const std::function<void(const Row&)>& fn) {
+    const Row row(stmt);
+    int rc;
+    while((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        fn(row);
     }
-    
-    while(sqlite3_step(stmt) == SQLITE_ROW) {
-        ResultRow row;
-        int col_count = sqlite3_column_count(stmt);
-        for(int i = 0; i < col_count; ++i) {
-            row.columns.emplace_back(
-                reinterpret_cast<const char*>(sqlite3_column_text(stmt, i))
-            );
-        }
-        result.push_back(row);
+    if(rc != SQLITE_DONE) {
+        throw Error(sqlite3_errmsg(db), sqlite3_extended_errcode(db));
+    }
+}
+
+DatabaseManager::ReadConnection::ReadConnection(const std::string& path,
+                                                const StorageProfile& profile) {
+    const int flags = SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX;
+    if(sqlite3_open_v2(path.c_str(), &db_, flags, nullptr) != SQLITE_OK) {
+        std::string error = sqlite3_errmsg(db_);
+        sqlite3_close(db_);
+        throw std::runtime_error(error);
     }
-    
-    sqlite3_finalize(stmt);
+    try {
+        apply_profile(db_, profile, false);
+    } catch(...) {
+        sqlite3_close(db_);
+        throw;
+    }
+    statements_.attach(db_);
+}
+
+DatabaseManager::ReadConnection::~ReadConnection() {
+    statements_.clear();
+    sqlite3_close(db_);
+}
+
+std::vector<DatabaseManager::ResultRow> DatabaseManager::ReadConnection::fetch_all(
+    const std::string& query, const std::vector<Value>& params) {
+    std::vector<ResultRow> result;
+    for_each_row(query, params, [&result](const Row& row) {
+        result.emplace_back(row);
+    });
     return result;
 }
 
+void DatabaseManager::ReadConnection::for_each_row(const std::string& query,
+                                                   const std::vector<Value>& params,
+                                                   const std::function<void(const Row&)>& fn) {
+    Statement stmt = statements_.acquire(query);
+    bind_params(db_, stmt.get(), params);
+    step_rows(db_, stmt.get(), fn);
+}
+
+DatabaseManager::ReadConnection& DatabaseManager::reader() {
+    if(pending_count_.load() > 0) flush();
+
+    std::lock_guard<std::mutex> lock(readers_mutex_);
+    if(db_path_.empty()) throw std::runtime_error("Database not connected");
+
+    auto& connection = readers_[std::this_thread::get_id()];
+    if(!connection) {
+        try {
+            connection.reset(new ReadConnection(db_path_, profile_));
+        } catch(...) {
+            readers_.erase(std::this_thread::get_id());
+            throw;
+        }
+        reader_release.manager = this;
+    }
+    return *connection;
+}
+
+size_t DatabaseManager::reader_count() {
+    std::lock_guard<std::mutex> lock(readers_mutex_);
+    return readers_.size();
+}
+
+void DatabaseManager::release_reader() {
+    std::lock_guard<std::mutex> lock(readers_mutex_);
+    readers_.erase(std::this_thread::get_id());
+}
+
+void DatabaseManager::close_readers() {
+    std::lock_guard<std::mutex> lock(readers_mutex_);
+    readers_.clear();
+    db_path_.clear();
+}
+
+int DatabaseManager::Row::size() const noexcept {
+    return sqlite3_column_count(stmt_);
+}
+
+int DatabaseManager::Row::column_type(int i) const noexcept {
+    return sqlite3_column_type(stmt_, i);
+}
+
+bool DatabaseManager::Row::is_null(int i) const noexcept {
+    return column_type(i) == SQLITE_NULL;
+}
+
+int DatabaseManager::Row::get_int(int i) const noexcept {
+    return sqlite3_column_int(stmt_, i);
+}
+
+int64_t DatabaseManager::Row::get_int64(int i) const noexcept {
+    return sqlite3_column_int64(stmt_, i);
+}
+
+double DatabaseManager::Row::get_double(int i) const noexcept {
+    return sqlite3_column_double(stmt_, i);
+}
+
+std::string_view DatabaseManager::Row::get_text(int i) const noexcept {
+    const auto* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt_, i));
+    if(!text) return {};
+    return std::string_view(text, sqlite3_column_bytes(stmt_, i));
+}
+
+DatabaseManager::ResultRow::ResultRow(const Row& row) {
+    const int count = row.size();
+    columns_.reserve(count);
+    for(int i = 0; i < count; ++i) {
+        switch(row.column_type(i)) {
+            case SQLITE_INTEGER:
+                columns_.emplace_back(row.get_int64(i));
+                break;
+            case SQLITE_FLOAT:
+                columns_.emplace_back(row.get_double(i));
+                break;
+            case SQLITE_NULL:
+                columns_.emplace_back(std::monostate{});
+                break;
+            default:
+                columns_.emplace_back(std::string(row.get_text(i)));
+                break;
+        }
+    }
+}
+
+int DatabaseManager::ResultRow::size() const noexcept {
+    return static_cast<int>(columns_.size());
+}
+
+bool DatabaseManager::ResultRow::is_null(int i) const {
+    return std::holds_alternative<std::monostate>(columns_.at(i));
+}
+
+int DatabaseManager::ResultRow::get_int(int i) const {
+    return static_cast<int>(get_int64(i));
+}
+
+int64_t DatabaseManager::ResultRow::get_int64(int i) const {
+    const Field& field = columns_.at(i);
+    if(auto v = std::get_if<int64_t>(&field)) return *v;
+    if(auto v = std::get_if<double>(&field)) return static_cast<int64_t>(*v);
+    if(auto v = std::get_if<std::string>(&field)) return std::stoll(*v);
+    return 0;
+}
+
+double DatabaseManager::ResultRow::get_double(int i) const {
+    const Field& field = columns_.at(i);
+    if(auto v = std::get_if<double>(&field)) return *v;
+    if(auto v = std::get_if<int64_t>(&field)) return static_cast<double>(*v);
+    if(auto v = std::get_if<std::string>(&field)) return std::stod(*v);
+    return 0.0;
+}
+
+std::string_view DatabaseManager::ResultRow::get_text(int i) const {
+    const Field& field = columns_.at(i);
+    if(auto v = std::get_if<std::string>(&field)) return *v;
+    return {};
+}
+
+int64_t DatabaseManager::last_insert_id() const {
+    if(writer_thread_of == this) return sqlite3_last_insert_rowid(writer_db_);
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    check_connection();
+    return sqlite3_last_insert_rowid(db_);
+}
+
+int64_t DatabaseManager::insert(const std::string& query, const std::vector<Value>& params) {
+    Session session(*this);
+    run(session.db(), session.statements(), query, params);
+    return sqlite3_last_insert_rowid(session.db());
+}
+
 void DatabaseManager::begin_transaction() {
     execute("BEGIN TRANSACTION");
 }
@@ -97,4 +535,265 @@ void DatabaseManager::commit_transaction() {
 
 void DatabaseManager::rollback_transaction() {
     execute("ROLLBACK");
-}
\ No newline at end of file
+}
+
+// Писать могут два соединения: блокировка записи берётся сразу (с ожиданием
+// busy_timeout), иначе транзакция, начатая чтением, получила бы SQLITE_BUSY
+// при первой записи без всякого ожидания
+void DatabaseManager::transaction(const std::function<void()>& fn) {
+    Session session(*this);
+    run(session.db(), session.statements(), "BEGIN IMMEDIATE", {});
+    try {
+        fn();
+        run(session.db(), session.statements(), "COMMIT", {});
+    } catch(...) {
+        try {
+            run(session.db(), session.statements(), "ROLLBACK", {});
+        } catch(...) {
+            // Исходная ошибка важнее ошибки отката
+        }
+        throw;
+    }
+}
+
+DatabaseManager::WriteTicket DatabaseManager::submit(const std::string& query,
+                                                     const std::vector<Value>& params) {
+    if(!group_commit_enabled()) {
+        execute(query, params);
+        std::promise<void> done;
+        done.set_value();
+        return done.get_future().share();
+    }
+
+    PendingWrite write;
+    write.query = query;
+    write.params = own_params(params);
+    write.queued_at = std::chrono::steady_clock::now();
+    WriteTicket ticket = write.done.get_future().share();
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        pending_.push_back(std::move(write));
+        ++pending_count_;
+        if(pending_.size() == 1 || pending_.size() >= group_commit_.max_batch) {
+            queue_cv_.notify_one();
+        }
+    }
+    return ticket;
+}
+
+void DatabaseManager::flush() {
+    SharedCall call(*this);
+    drain_pending();
+}
+
+std::vector<DatabaseManager::OwnedValue> DatabaseManager::own_params(const std::vector<Value>& params) {
+    std::vector<OwnedValue> owned;
+    owned.reserve(params.size());
+    for(const auto& value : params) {
+        switch(value.type()) {
+            case Value::Type::Null: owned.emplace_back(std::monostate{}); break;
+            case Value::Type::Integer: owned.emplace_back(value.integer()); break;
+            case Value::Type::Real: owned.emplace_back(value.real()); break;
+            case Value::Type::Text: owned.emplace_back(std::string(value.text())); break;
+        }
+    }
+    return owned;
+}
+
+std::vector<DatabaseManager::Value> DatabaseManager::borrow_params(const std::vector<OwnedValue>& params) {
+    std::vector<Value> values;
+    values.reserve(params.size());
+    for(const auto& field : params) {
+        if(auto v = std::get_if<int64_t>(&field)) values.emplace_back(static_cast<long long>(*v));
+        else if(auto v = std::get_if<double>(&field)) values.emplace_back(*v);
+        else if(auto v = std::get_if<std::string>(&field)) values.emplace_back(*v);
+        else values.emplace_back(nullptr);
+    }
+    return values;
+}
+
+std::future<void> DatabaseManager::execute_async(const std::string& query,
+                                                 const std::vector<Value>& params) {
+    return run_async([this, query, owned = own_params(params)] {
+        execute(query, borrow_params(owned));
+    });
+}
+
+std::future<int64_t> DatabaseManager::insert_async(const std::string& query,
+                                                   const std::vector<Value>& params) {
+    return run_async([this, query, owned = own_params(params)] {
+        return insert(query, borrow_params(owned));
+    });
+}
+
+void DatabaseManager::enqueue_async(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(async_mutex_);
+        if(!writer_.joinable()) {
+            throw std::runtime_error("Database not connected");
+        }
+        async_tasks_.push_back(std::move(task));
+    }
+    async_cv_.notify_one();
+}
+
+void DatabaseManager::wait_async() {
+    std::unique_lock<std::mutex> lock(async_mutex_);
+    async_idle_cv_.wait(lock, [this] { return async_tasks_.empty() && !writer_busy_; });
+}
+
+void DatabaseManager::start_writer() {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    if(writer_.joinable()) return;
+    stop_writer_ = false;
+    writer_ = std::thread(&DatabaseManager::writer_loop, this);
+}
+
+void DatabaseManager::stop_writer() {
+    std::thread writer;
+    {
+        std::lock_guard<std::mutex> lock(async_mutex_);
+        stop_writer_ = true;
+        writer = std::move(writer_);
+    }
+    async_cv_.notify_all();
+    if(writer.joinable()) writer.join();
+}
+
+// Задачи выполняются без удержания mutex_: обычные методы внутри них идут
+// через соединение потока, и задачи могут брать свои блокировки в привычном
+// порядке
+void DatabaseManager::writer_loop() {
+    writer_thread_of = this;
+    std::unique_lock<std::mutex> lock(async_mutex_);
+    while(true) {
+        async_cv_.wait(lock, [this] { return stop_writer_ || !async_tasks_.empty(); });
+        if(async_tasks_.empty()) break;
+
+        auto task = std::move(async_tasks_.front());
+        async_tasks_.pop_front();
+        writer_busy_ = true;
+        lock.unlock();
+        task();
+        lock.lock();
+        writer_busy_ = false;
+        if(async_tasks_.empty()) async_idle_cv_.notify_all();
+    }
+    async_idle_cv_.notify_all();
+}
+
+void DatabaseManager::set_group_commit(const GroupCommitPolicy& policy) {
+    stop_flusher();
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        group_commit_ = policy;
+        if(group_commit_.max_batch == 0) group_commit_.max_batch = 1;
+    }
+    if(policy.enabled) {
+        flusher_ = std::thread(&DatabaseManager::flusher_loop, this);
+    } else {
+        flush();
+    }
+}
+
+bool DatabaseManager::group_commit_enabled() const {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return group_commit_.enabled;
+}
+
+void DatabaseManager::stop_flusher() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        stop_flusher_ = true;
+    }
+    queue_cv_.notify_all();
+    if(flusher_.joinable()) flusher_.join();
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    stop_flusher_ = false;
+}
+
+void DatabaseManager::flusher_loop() {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    while(!stop_flusher_) {
+        if(pending_.empty()) {
+            queue_cv_.wait(lock);
+            continue;
+        }
+
+        const auto deadline = pending_.front().queued_at + group_commit_.max_delay;
+        queue_cv_.wait_until(lock, deadline, [this] {
+            return stop_flusher_ || pending_.size() >= group_commit_.max_batch;
+        });
+        if(stop_flusher_) break;
+        lock.unlock();
+
+        bool deferred = false;
+        {
+            SharedCall call(*this);
+            if(db_ && sqlite3_get_autocommit(db_)) {
+                drain_pending();
+            } else {
+                deferred = true;
+            }
+        }
+
+        lock.lock();
+        if(deferred && !stop_flusher_) {
+            queue_cv_.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+}
+
+// Вызывается под mutex_. Очередь забирается целиком, поэтому flush() под тем же
+// мьютексом гарантирует, что все ранее принятые изменения уже записаны.
+// Внутри явной транзакции очередь не трогаем, чтобы не подмешивать в неё чужие записи.
+void DatabaseManager::drain_pending() {
+    if(pending_count_.load() == 0 || !db_ || !sqlite3_get_autocommit(db_)) return;
+
+    std::deque<PendingWrite> batch;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        batch.swap(pending_);
+        pending_count_ = 0;
+    }
+    if(!batch.empty()) write_batch(batch);
+}
+
+void DatabaseManager::write_batch(std::deque<PendingWrite>& batch) {
+    std::vector<std::exception_ptr> errors(batch.size());
+    const bool own_transaction = sqlite3_get_autocommit(db_) != 0;
+
+    try {
+        if(own_transaction) run("BEGIN IMMEDIATE", {});
+
+        for(size_t i = 0; i < batch.size(); ++i) {
+            const std::vector<Value> params = borrow_params(batch[i].params);
+
+            // Ошибка одного изменения не должна откатывать остальные
+            run("SAVEPOINT group_write", {});
+            try {
+                run(batch[i].query, params);
+                run("RELEASE group_write", {});
+            } catch(...) {
+                errors[i] = std::current_exception();
+                run("ROLLBACK TO group_write", {});
+                run("RELEASE group_write", {});
+            }
+        }
+
+        if(own_transaction) run("COMMIT", {});
+    } catch(...) {
+        const auto error = std::current_exception();
+        if(own_transaction && !sqlite3_get_autocommit(db_)) {
+            sqlite3_exec(db_, "ROLLBACK", nullptr, nullptr, nullptr);
+        }
+        for(auto& write : batch) write.done.set_exception(error);
+        return;
+    }
+
+    for(size_t i = 0; i < batch.size(); ++i) {
+        if(errors[i]) batch[i].done.set_exception(errors[i]);
+        else batch[i].done.set_value();
+    }
+}
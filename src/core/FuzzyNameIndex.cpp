@@ -0,0 +1,314 @@
+#include "../../include/core/FuzzyNameIndex.h"
+#include "../../include/core/Utf8.h"
+#include <algorithm>
+#include <cstdlib>
+
+void FuzzyNameIndex::clear() {
+    nodes_.assign(1, Node{U'\0'});
+    term_text_.clear();
+    term_start_.assign(1, 0);
+    term_ids_.clear();
+    client_terms_.clear();
+    bigrams_.clear();
+    max_length_ = 0;
+}
+
+std::vector<std::u32string> FuzzyNameIndex::split_words(std::string_view text) {
+    std::vector<std::u32string> words;
+    std::u32string current;
+    bool has_letter = false;
+
+    // Слова из одних цифр не индексируются: числа одной длины отличаются
+    // парой правок, и опечатка в имени находила бы случайные номера
+    const auto finish_word = [&] {
+        if(has_letter) words.push_back(std::move(current));
+        current.clear();
+        has_letter = false;
+    };
+
+    for(char32_t c : Utf8::fold_decode(text)) {
+        const bool separator = c == U' ' || c == U'\t' || c == U'-' ||
+                               c == U'.' || c == U',';
+        if(separator) {
+            finish_word();
+        } else {
+            has_letter = has_letter || c < U'0' || c > U'9';
+            current.push_back(c);
+        }
+    }
+    finish_word();
+    return words;
+}
+
+std::vector<uint64_t> FuzzyNameIndex::word_bigrams(const std::u32string& word) {
+    // Границы слова - символы 0 и 1: первая и последняя буквы тоже дают биграммы
+    std::vector<uint64_t> result;
+    result.reserve(word.size() + 1);
+    char32_t previous = 0;
+    for(char32_t c : word) {
+        result.push_back(static_cast<uint64_t>(previous) << 32 | c);
+        previous = c;
+    }
+    result.push_back(static_cast<uint64_t>(previous) << 32 | 1u);
+    return result;
+}
+
+int FuzzyNameIndex::distance(std::u32string_view a, std::u32string_view b) {
+    return distance(a, b, static_cast<int>(std::max(a.size(), b.size())));
+}
+
+int FuzzyNameIndex::distance(std::u32string_view a, std::u32string_view b, int bound) {
+    if(a.size() < b.size()) return distance(b, a, bound);
+
+    const int n = static_cast<int>(a.size());
+    const int m = static_cast<int>(b.size());
+    const int over = bound + 1;
+    if(n - m > bound) return over;
+
+    // Две строки таблицы в буфере потока: поиск не выделяет память на слово
+    thread_local std::vector<int> rows;
+    rows.assign(2 * static_cast<size_t>(m + 1), over);
+    int* previous = rows.data();
+    int* current = previous + m + 1;
+    for(int j = 0; j <= std::min(m, bound); ++j) previous[j] = j;
+
+    for(int i = 1; i <= n; ++i) {
+        const int lo = std::max(1, i - bound);
+        const int hi = std::min(m, i + bound);
+        current[lo - 1] = lo == 1 ? std::min(i, over) : over;
+        int row_min = current[lo - 1];
+        for(int j = lo; j <= hi; ++j) {
+            const int substitution = previous[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1);
+            const int value = std::min({previous[j] + 1, current[j - 1] + 1, substitution, over});
+            current[j] = value;
+            row_min = std::min(row_min, value);
+        }
+        // Клетка за полосой читается следующей строкой как "больше bound"
+        if(hi < m) current[hi + 1] = over;
+        if(row_min > bound) return over;
+        std::swap(previous, current);
+    }
+    return std::min(previous[m], over);
+}
+
+uint32_t FuzzyNameIndex::find_term(const std::u32string& word) const {
+    uint32_t node = 0;
+    for(char32_t c : word) {
+        uint32_t child = nodes_[node].first_child;
+        while(child != none && nodes_[child].symbol != c) child = nodes_[child].next_sibling;
+        if(child == none) return none;
+        node = child;
+    }
+    return nodes_[node].term;
+}
+
+uint32_t FuzzyNameIndex::insert_term(const std::u32string& word) {
+    uint32_t node = 0;
+    for(char32_t c : word) {
+        uint32_t child = nodes_[node].first_child;
+        while(child != none && nodes_[child].symbol != c) child = nodes_[child].next_sibling;
+        if(child == none) {
+            child = static_cast<uint32_t>(nodes_.size());
+            Node created{c};
+            created.next_sibling = nodes_[node].first_child;
+            nodes_.push_back(created);
+            nodes_[node].first_child = child;
+        }
+        node = child;
+    }
+    if(nodes_[node].term == none) {
+        const auto created = static_cast<uint32_t>(term_ids_.size());
+        nodes_[node].term = created;
+        term_ids_.emplace_back();
+        term_text_ += word;
+        term_start_.push_back(static_cast<uint32_t>(term_text_.size()));
+        // Номера слов растут, поэтому списки биграмм остаются упорядоченными
+        for(uint64_t bigram : word_bigrams(word)) bigrams_[bigram].push_back(created);
+        max_length_ = std::max(max_length_, word.size());
+    }
+    return nodes_[node].term;
+}
+
+void FuzzyNameIndex::add(int id, std::string_view name) {
+    if(id < 0) return;
+    const auto index = static_cast<size_t>(id);
+    if(index >= client_terms_.size()) client_terms_.resize(index + 1);
+    auto& terms = client_terms_[index];
+
+    for(const auto& word : split_words(name)) {
+        const uint32_t term = insert_term(word);
+        // Клиент добавляется целиком, поэтому повтор слова в одном имени
+        // виден по последнему id
+        auto& ids = term_ids_[term];
+        if(ids.empty() || ids.back() != id) ids.push_back(id);
+        if(std::find(terms.begin(), terms.end(), term) == terms.end()) terms.push_back(term);
+    }
+}
+
+void FuzzyNameIndex::remove(int id, std::string_view name) {
+    if(id < 0 || static_cast<size_t>(id) >= client_terms_.size()) return;
+    auto& terms = client_terms_[static_cast<size_t>(id)];
+    for(const auto& word : split_words(name)) {
+        // Узлы слова остаются в дереве, даже если в нём нет клиентов
+        const uint32_t term = find_term(word);
+        if(term == none) continue;
+        auto& ids = term_ids_[term];
+        ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+        terms.erase(std::remove(terms.begin(), terms.end(), term), terms.end());
+    }
+}
+
+// Строка таблицы для узла глубины depth считается из строки родителя;
+// rows хранит строки всего пути от корня
+void FuzzyNameIndex::walk(uint32_t node, size_t depth, const std::u32string& word, int max_edits,
+                          std::vector<int>& rows, std::vector<TermMatch>& found) const {
+    const size_t width = word.size() + 1;
+    const int* previous = rows.data() + (depth - 1) * width;
+    int* current = rows.data() + depth * width;
+    const char32_t symbol = nodes_[node].symbol;
+
+    current[0] = static_cast<int>(depth);
+    int row_min = current[0];
+    for(size_t j = 1; j < width; ++j) {
+        const int substitution = previous[j - 1] + (word[j - 1] == symbol ? 0 : 1);
+        current[j] = std::min({previous[j] + 1, current[j - 1] + 1, substitution});
+        row_min = std::min(row_min, current[j]);
+    }
+    if(nodes_[node].term != none && current[width - 1] <= max_edits) {
+        found.emplace_back(nodes_[node].term, current[width - 1]);
+    }
+    // Дальше по дереву расстояние не уменьшается
+    if(row_min > max_edits) return;
+    for(uint32_t child = nodes_[node].first_child; child != none; child = nodes_[child].next_sibling) {
+        walk(child, depth + 1, word, max_edits, rows, found);
+    }
+}
+
+// Слова в пределах max_edits правок имеют с word не меньше threshold общих
+// биграмм (с повторами): считаются только слова из списков биграмм запроса
+// подходящей длины, расстояние проверяется у набравших порог
+void FuzzyNameIndex::filter(const std::u32string& word, int max_edits, int threshold,
+                            std::vector<TermMatch>& found) const {
+    thread_local std::vector<uint8_t> counts;
+    thread_local std::vector<uint32_t> touched;
+    counts.resize(term_ids_.size());
+
+    auto bigrams = word_bigrams(word);
+    std::sort(bigrams.begin(), bigrams.end());
+    for(size_t i = 0; i < bigrams.size();) {
+        size_t repeats = 1;
+        while(i + repeats < bigrams.size() && bigrams[i + repeats] == bigrams[i]) ++repeats;
+        auto list = bigrams_.find(bigrams[i]);
+        i += repeats;
+        if(list == bigrams_.end()) continue;
+
+        const auto& terms = list->second;
+        for(size_t at = 0; at < terms.size();) {
+            const uint32_t term = terms[at];
+            size_t run = 1;
+            while(at + run < terms.size() && terms[at + run] == term) ++run;
+            at += run;
+            if(counts[term] == 0) touched.push_back(term);
+            counts[term] = static_cast<uint8_t>(std::min<size_t>(255, counts[term] + std::min(run, repeats)));
+        }
+    }
+
+    const auto length = static_cast<int>(word.size());
+    for(uint32_t term : touched) {
+        const auto text = this->term(term);
+        if(counts[term] >= threshold && std::abs(static_cast<int>(text.size()) - length) <= max_edits) {
+            const int d = distance(word, text, max_edits);
+            if(d <= max_edits) found.emplace_back(term, d);
+        }
+        counts[term] = 0;
+    }
+    touched.clear();
+}
+
+void FuzzyNameIndex::collect(const std::u32string& word, int max_edits,
+                             std::vector<TermMatch>& found) const {
+    // Порог общих биграмм для строк длины не меньше |word|: |word| + 1 - 2k.
+    // При пороге 0-1 фильтр пропускает почти всё - короткие слова ищутся в дереве
+    const int threshold = static_cast<int>(word.size()) + 1 - 2 * max_edits;
+    if(threshold >= 2) {
+        filter(word, max_edits, threshold, found);
+        return;
+    }
+
+    // Буфер потока: поиск не выделяет память на узел
+    thread_local std::vector<int> rows;
+    const size_t width = word.size() + 1;
+    rows.resize((max_length_ + 1) * width);
+    for(size_t j = 0; j < width; ++j) rows[j] = static_cast<int>(j);
+    for(uint32_t child = nodes_[0].first_child; child != none; child = nodes_[child].next_sibling) {
+        walk(child, 1, word, max_edits, rows, found);
+    }
+}
+
+std::vector<FuzzyNameIndex::Match> FuzzyNameIndex::search(std::string_view query,
+                                                          int max_edits,
+                                                          size_t limit) const {
+    std::vector<Match> result;
+    const auto words = split_words(query);
+    if(words.empty() || term_ids_.empty() || limit == 0) return result;
+
+    // Кандидатов даёт слово с наименьшим числом клиентов. Слова ищутся от
+    // длинных (их фильтр строже) к коротким, пока не найдётся достаточно
+    // редкое: остальные дешевле сверить со словами кандидатов
+    std::vector<size_t> order(words.size());
+    for(size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+        [&words](size_t a, size_t b) { return words[a].size() > words[b].size(); });
+
+    size_t driver = order[0];
+    size_t driver_count = SIZE_MAX;
+    std::vector<TermMatch> found;
+    for(size_t i : order) {
+        std::vector<TermMatch> word_found;
+        collect(words[i], max_edits, word_found);
+        size_t count = 0;
+        for(const auto& [term, d] : word_found) count += term_ids_[term].size();
+        if(count == 0) return result;
+        if(count < driver_count) {
+            driver = i;
+            driver_count = count;
+            found = std::move(word_found);
+        }
+        if(driver_count <= selective_count) break;
+    }
+
+    std::unordered_map<int, int> best;
+    best.reserve(driver_count);
+    for(const auto& [term, d] : found) {
+        for(int id : term_ids_[term]) {
+            auto [it, inserted] = best.emplace(id, d);
+            if(!inserted && d < it->second) it->second = d;
+        }
+    }
+
+    // Остальные слова запроса сверяются со словами кандидата
+    result.reserve(best.size());
+    for(const auto& [id, d] : best) {
+        int total = d;
+        for(size_t i = 0; i < words.size() && total >= 0; ++i) {
+            if(i == driver) continue;
+            int word_best = max_edits + 1;
+            for(uint32_t term : client_terms_[static_cast<size_t>(id)]) {
+                word_best = std::min(word_best, distance(words[i], this->term(term), max_edits));
+            }
+            total = word_best > max_edits ? -1 : total + word_best;
+        }
+        if(total >= 0) result.push_back({id, total});
+    }
+
+    const auto by_rank = [](const Match& a, const Match& b) {
+        return a.distance != b.distance ? a.distance < b.distance : a.id < b.id;
+    };
+    if(result.size() > limit) {
+        std::partial_sort(result.begin(), result.begin() + limit, result.end(), by_rank);
+        result.resize(limit);
+    } else {
+        std::sort(result.begin(), result.end(), by_rank);
+    }
+    return result;
+}
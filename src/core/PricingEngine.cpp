@@ -0,0 +1,311 @@
+#include "../../include/core/PricingEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define PRICING_HAS_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+PricingEngine::WeekSchedule PricingEngine::default_schedule() {
+    WeekSchedule schedule;
+    for(size_t hour = 0; hour < schedule.size(); ++hour) {
+        const size_t day = hour / 24;
+        const bool weekend = day >= 5;
+        const bool evening = hour % 24 >= 18;
+        schedule[hour] = weekend || evening ? Tariff::Period::Peak : Tariff::Period::OffPeak;
+    }
+    return schedule;
+}
+
+PricingEngine::PricingEngine() : schedule_(default_schedule()) {}
+
+void PricingEngine::set_tariff(Seat::Type type, const Tariff& tariff) {
+    tariffs_[static_cast<size_t>(type)][static_cast<size_t>(tariff.period())] = tariff;
+}
+
+void PricingEngine::set_schedule(const WeekSchedule& schedule) {
+    schedule_ = schedule;
+}
+
+void PricingEngine::add_holiday(time_t start, time_t end) {
+    if(start >= end) {
+        throw std::invalid_argument("Holiday start must be before end");
+    }
+    holidays_.push_back({start, end});
+}
+
+const Tariff* PricingEngine::tariff_for(Seat::Type type, Tariff::Period period) const {
+    const auto& by_period = tariffs_[static_cast<size_t>(type)];
+    if(const auto& tariff = by_period[static_cast<size_t>(period)]) return &*tariff;
+    if(const auto& peak = by_period[static_cast<size_t>(Tariff::Period::Peak)]) return &*peak;
+    return nullptr;
+}
+
+Tariff::Period PricingEngine::period_at(time_t t) const {
+    for(const auto& holiday : holidays_) {
+        if(t >= holiday.start && t < holiday.end) return Tariff::Period::Holiday;
+    }
+    std::tm local{};
+    localtime_r(&t, &local);
+    const int weekday = (local.tm_wday + 6) % 7;   // tm_wday: 0 - воскресенье
+    return schedule_[static_cast<size_t>(weekday * 24 + local.tm_hour)];
+}
+
+double PricingEngine::rate_at(Seat::Type type, Tariff::Period period, time_t t) const {
+    const Tariff* tariff = tariff_for(type, period);
+    if(!tariff) return 0.0;
+
+    double discount = 0.0;
+    for(const auto& d : tariff->discounts()) {
+        if(t >= d.start && t < d.end) discount = std::max(discount, d.percent);
+    }
+    return tariff->base_rate() / 3600.0 * (1.0 - discount / 100.0);
+}
+
+void PricingEngine::compile(time_t from, time_t to) {
+    if(from >= to) {
+        throw std::invalid_argument("Pricing horizon start must be before end");
+    }
+
+    // Ставка может смениться только на границе местного часа, праздника
+    // или скидки
+    std::vector<time_t> candidates{from};
+    for(time_t t = from; t < to;) {
+        std::tm local{};
+        localtime_r(&t, &local);
+        t += 3600 - (local.tm_min * 60 + local.tm_sec);
+        if(t < to) candidates.push_back(t);
+    }
+    const auto add_bounds = [&](time_t start, time_t end) {
+        if(start > from && start < to) candidates.push_back(start);
+        if(end > from && end < to) candidates.push_back(end);
+    };
+    for(const auto& holiday : holidays_) add_bounds(holiday.start, holiday.end);
+    for(const auto& by_period : tariffs_) {
+        for(const auto& tariff : by_period) {
+            if(!tariff) continue;
+            for(const auto& d : tariff->discounts()) add_bounds(d.start, d.end);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // Соседние отрезки с одинаковыми ставками всех типов сливаются
+    std::vector<time_t> breakpoints;
+    std::array<std::vector<double>, seat_type_count> rates;
+    for(time_t start : candidates) {
+        const Tariff::Period period = period_at(start);
+        std::array<double, seat_type_count> current;
+        for(size_t type = 0; type < seat_type_count; ++type) {
+            current[type] = rate_at(static_cast<Seat::Type>(type), period, start);
+        }
+        bool same = !breakpoints.empty();
+        for(size_t type = 0; same && type < seat_type_count; ++type) {
+            same = rates[type].back() == current[type];
+        }
+        if(same) continue;
+
+        breakpoints.push_back(start);
+        for(size_t type = 0; type < seat_type_count; ++type) rates[type].push_back(current[type]);
+    }
+    breakpoints.push_back(to);
+
+    std::array<std::vector<double>, seat_type_count> prefix;
+    for(size_t type = 0; type < seat_type_count; ++type) {
+        prefix[type].resize(breakpoints.size());
+        prefix[type][0] = 0.0;
+        for(size_t i = 0; i + 1 < breakpoints.size(); ++i) {
+            prefix[type][i + 1] = prefix[type][i] +
+                rates[type][i] * static_cast<double>(breakpoints[i + 1] - breakpoints[i]);
+        }
+    }
+
+    const size_t points = breakpoints.size();
+    std::vector<double> flat_rates(seat_type_count * points, 0.0);
+    std::vector<double> flat_prefix(seat_type_count * points);
+    for(size_t type = 0; type < seat_type_count; ++type) {
+        std::copy(rates[type].begin(), rates[type].end(), flat_rates.begin() + type * points);
+        std::copy(prefix[type].begin(), prefix[type].end(), flat_prefix.begin() + type * points);
+    }
+
+    breakpoints_ = std::move(breakpoints);
+    rates_ = std::move(rates);
+    prefix_ = std::move(prefix);
+    flat_rates_ = std::move(flat_rates);
+    flat_prefix_ = std::move(flat_prefix);
+}
+
+bool PricingEngine::covers(time_t start, time_t end) const noexcept {
+    return !breakpoints_.empty() && start >= breakpoints_.front() && end <= breakpoints_.back();
+}
+
+const std::vector<double>& PricingEngine::rates(Seat::Type type) const noexcept {
+    return rates_[static_cast<size_t>(type)];
+}
+
+const std::vector<double>& PricingEngine::prefix(Seat::Type type) const noexcept {
+    return prefix_[static_cast<size_t>(type)];
+}
+
+double PricingEngine::round_price(double cost) noexcept {
+    return std::round(cost * 100.0) / 100.0;
+}
+
+double PricingEngine::cost_until(size_t type, time_t t) const {
+    // Последний отрезок, начинающийся не позже t
+    const auto it = std::upper_bound(breakpoints_.begin(), breakpoints_.end(), t);
+    const size_t i = static_cast<size_t>(it - breakpoints_.begin()) - 1;
+    if(i + 1 == breakpoints_.size()) return prefix_[type][i];
+    return prefix_[type][i] + rates_[type][i] * static_cast<double>(t - breakpoints_[i]);
+}
+
+double PricingEngine::price(Seat::Type type, time_t start, time_t end) const {
+    if(start >= end) {
+        throw std::invalid_argument("Start time must be before end time");
+    }
+    if(!covers(start, end)) {
+        throw std::out_of_range("Interval is outside the pricing horizon");
+    }
+    const auto index = static_cast<size_t>(type);
+    return round_price(cost_until(index, end) - cost_until(index, start));
+}
+
+void PricingEngine::validate_batch(const BatchColumns& batch) const {
+    const size_t count = batch.start.size();
+    if(batch.end.size() != count || batch.seat_type.size() != count) {
+        throw std::invalid_argument("Batch columns must have equal length");
+    }
+    for(size_t i = 0; i < count; ++i) {
+        if(batch.seat_type[i] < 0 || static_cast<size_t>(batch.seat_type[i]) >= seat_type_count) {
+            throw std::invalid_argument("Unknown seat type in batch");
+        }
+        if(batch.start[i] >= batch.end[i]) {
+            throw std::invalid_argument("Start time must be before end time");
+        }
+        if(!covers(batch.start[i], batch.end[i])) {
+            throw std::out_of_range("Interval is outside the pricing horizon");
+        }
+    }
+}
+
+std::vector<double> PricingEngine::price_batch(const BatchColumns& batch) const {
+    validate_batch(batch);
+    std::vector<double> out(batch.start.size());
+#ifdef PRICING_HAS_AVX2_KERNEL
+    if(simd_available()) {
+        price_batch_avx2(batch, out.data());
+        return out;
+    }
+#endif
+    price_batch_scalar(batch, out.data());
+    return out;
+}
+
+void PricingEngine::price_batch_scalar(const BatchColumns& batch, double* out) const {
+    for(size_t i = 0; i < batch.start.size(); ++i) {
+        const auto type = static_cast<size_t>(batch.seat_type[i]);
+        out[i] = round_price(cost_until(type, batch.end[i]) - cost_until(type, batch.start[i]));
+    }
+}
+
+bool PricingEngine::simd_available() noexcept {
+#ifdef PRICING_HAS_AVX2_KERNEL
+    static const bool available = __builtin_cpu_supports("avx2");
+    return available;
+#else
+    return false;
+#endif
+}
+
+#ifdef PRICING_HAS_AVX2_KERNEL
+
+namespace {
+
+static_assert(sizeof(time_t) == sizeof(int64_t), "AVX2 kernel expects 64-bit time_t");
+
+// Индекс последней точки <= t для четырёх моментов: бинарный поиск без
+// ветвлений с одинаковым числом шагов во всех дорожках
+__attribute__((target("avx2")))
+__m256i segment_of(const int64_t* points, size_t count, __m256i t) {
+    __m256i base = _mm256_setzero_si256();
+    for(size_t length = count; length > 1;) {
+        const size_t half = length / 2;
+        const __m256i probe = _mm256_add_epi64(base, _mm256_set1_epi64x(static_cast<long long>(half)));
+        const __m256i value = _mm256_i64gather_epi64(
+            reinterpret_cast<const long long*>(points), probe, 8);
+        // points[probe] <= t  <=>  !(points[probe] > t)
+        const __m256i greater = _mm256_cmpgt_epi64(value, t);
+        base = _mm256_blendv_epi8(probe, base, greater);
+        length -= half;
+    }
+    return base;
+}
+
+// Точное преобразование 0 <= x < 2^52 в double (в AVX2 нет cvtepi64_pd)
+__attribute__((target("avx2")))
+__m256d to_double(__m256i x) {
+    const __m256i magic = _mm256_set1_epi64x(0x4330000000000000LL);
+    const __m256d shifted = _mm256_castsi256_pd(_mm256_or_si256(x, magic));
+    return _mm256_sub_pd(shifted, _mm256_set1_pd(4503599627370496.0));
+}
+
+// std::round: половина округляется от нуля, а не к чётному
+__attribute__((target("avx2")))
+__m256d round_half_away(__m256d x) {
+    const __m256d truncated = _mm256_round_pd(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    const __m256d sign_mask = _mm256_set1_pd(-0.0);
+    const __m256d fraction = _mm256_andnot_pd(sign_mask, _mm256_sub_pd(x, truncated));
+    const __m256d carry = _mm256_cmp_pd(fraction, _mm256_set1_pd(0.5), _CMP_GE_OQ);
+    const __m256d one = _mm256_or_pd(_mm256_set1_pd(1.0), _mm256_and_pd(x, sign_mask));
+    return _mm256_add_pd(truncated, _mm256_and_pd(carry, one));
+}
+
+// prefix + rate * (t - начало отрезка) - та же формула, что в cost_until
+__attribute__((target("avx2")))
+__m256d cost_until4(const int64_t* points, size_t count,
+                    const double* flat_prefix, const double* flat_rates,
+                    __m256i t, __m256i type_offset) {
+    const __m256i segment = segment_of(points, count, t);
+    const __m256i flat = _mm256_add_epi64(type_offset, segment);
+    const __m256i start = _mm256_i64gather_epi64(
+        reinterpret_cast<const long long*>(points), segment, 8);
+    const __m256d prefix = _mm256_i64gather_pd(flat_prefix, flat, 8);
+    const __m256d rate = _mm256_i64gather_pd(flat_rates, flat, 8);
+    const __m256d elapsed = to_double(_mm256_sub_epi64(t, start));
+    return _mm256_add_pd(prefix, _mm256_mul_pd(rate, elapsed));
+}
+
+}
+
+__attribute__((target("avx2")))
+void PricingEngine::price_batch_avx2(const BatchColumns& batch, double* out) const {
+    const size_t count = batch.start.size();
+    const size_t points = breakpoints_.size();
+    const auto* bp = reinterpret_cast<const int64_t*>(breakpoints_.data());
+
+    const __m256d hundred = _mm256_set1_pd(100.0);
+    const __m256i stride = _mm256_set1_epi64x(static_cast<long long>(points));
+
+    size_t i = 0;
+    for(; i + 4 <= count; i += 4) {
+        const __m256i start = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&batch.start[i]));
+        const __m256i end = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&batch.end[i]));
+        const __m128i types = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&batch.seat_type[i]));
+        const __m256i type_offset = _mm256_mul_epu32(_mm256_cvtepi32_epi64(types), stride);
+
+        const __m256d cost = _mm256_sub_pd(
+            cost_until4(bp, points, flat_prefix_.data(), flat_rates_.data(), end, type_offset),
+            cost_until4(bp, points, flat_prefix_.data(), flat_rates_.data(), start, type_offset));
+        const __m256d rounded = _mm256_div_pd(round_half_away(_mm256_mul_pd(cost, hundred)), hundred);
+        _mm256_storeu_pd(out + i, rounded);
+    }
+
+    for(; i < count; ++i) {
+        const auto type = static_cast<size_t>(batch.seat_type[i]);
+        out[i] = round_price(cost_until(type, batch.end[i]) - cost_until(type, batch.start[i]));
+    }
+}
+
+#endif
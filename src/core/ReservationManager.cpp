@@ -1,163 +1,392 @@
 #include "../../include/core/ReservationManager.h"
 
+namespace {
+    // Шкала цен строится с запасом и расширяется, если бронь выходит за неё
+    constexpr time_t pricing_margin = 400 * 24 * 3600;
+}
+
 ReservationManager::ReservationManager(ClubSystem& clubSystem)
     : clubSystem_(clubSystem),   
-      db_(DatabaseManager::instance()) {}
+      db_(DatabaseManager::instance()) {
+    configure_default_tariffs();
+    const time_t now = time(nullptr);
+    pricing_.compile(now - pricing_margin, now + pricing_margin);
+}
+
+void ReservationManager::configure_default_tariffs() {
+    struct Rates { Seat::Type type; double peak; double off_peak; double holiday; };
+    static const Rates defaults[] = {
+        {Seat::Type::Standard,   120.0,  90.0, 150.0},
+        {Seat::Type::VIP,        200.0, 150.0, 250.0},
+        {Seat::Type::Gaming,     160.0, 120.0, 200.0},
+        {Seat::Type::Conference, 300.0, 240.0, 360.0}
+    };
+
+    int id = 1;
+    for(const auto& rates : defaults) {
+        pricing_.set_tariff(rates.type, Tariff(id++, "Пиковый", rates.peak, Tariff::Period::Peak));
+        pricing_.set_tariff(rates.type, Tariff(id++, "Дневной", rates.off_peak, Tariff::Period::OffPeak));
+        pricing_.set_tariff(rates.type, Tariff(id++, "Праздничный", rates.holiday, Tariff::Period::Holiday));
+    }
+}
+
+void ReservationManager::configure_pricing(const std::function<void(PricingEngine&)>& change) {
+    std::unique_lock<std::shared_mutex> lock(pricing_mutex_);
+    change(pricing_);
+    const auto& breakpoints = pricing_.breakpoints();
+    pricing_.compile(breakpoints.front(), breakpoints.back());
+}
 
 Reservation ReservationManager::create_reservation(int client_id, int seat_id, time_t start, time_t end) {
     TimeSlot slot{start, end};
     validate_time_slot(slot);
-    
-    if(!is_available(seat_id, slot)) {
-        throw std::runtime_error("Место недоступно для бронирования");
-    }
 
-    const Seat& seat = clubSystem_.get_seat(seat_id);
+    const Seat seat = clubSystem_.get_seat(seat_id);
     double price = calculate_price(seat, slot);
 
-    db_.execute(
+    // Проверка и вставка под одной блокировкой, иначе два потока займут один слот
+    std::unique_lock<std::mutex> lock(schedule_mutex_);
+    if(!schedule_.is_free(seat_id, slot.start, slot.end)) {
+        throw std::runtime_error("Место недоступно для бронирования");
+    }
+
+    const int id = static_cast<int>(db_.insert(
         "INSERT INTO reservations (client_id, seat_id, start_time, end_time, status, total_cost) "
         "VALUES (?, ?, ?, ?, ?, ?)",
         {
-            std::to_string(client_id),
-            std::to_string(seat_id),
-            std::to_string(start),
-            std::to_string(end),
-            std::to_string(static_cast<int>(Reservation::Status::Pending)),
-            std::to_string(price)
+            client_id,
+            seat_id,
+            start,
+            end,
+            static_cast<int>(Reservation::Status::Pending),
+            price
         }
-    );
+    ));
+    schedule_.add(seat_id, id, start, end);
+    Reservation created(id, client_id, seat_id, start, end,
+                        Reservation::Status::Pending, price);
+    {
+        std::unique_lock<std::shared_mutex> store_lock(store_mutex_);
+        store_.upsert(created);
+    }
+    lock.unlock();
 
     clubSystem_.update_seat_status(seat_id, Seat::Status::Reserved);
 
-    return load_reservation(get_last_insert_id());
+    return created;
+}
+
+std::future<Reservation> ReservationManager::create_reservation_async(int client_id, int seat_id,
+                                                                      time_t start, time_t end) {
+    return db_.run_async([this, client_id, seat_id, start, end] {
+        return create_reservation(client_id, seat_id, start, end);
+    });
+}
+
+std::vector<ReservationManager::Result> ReservationManager::create_reservations(
+        const std::vector<Request>& requests) {
+    std::vector<Result> results(requests.size());
+    std::vector<double> prices(requests.size(), 0.0);
+    std::vector<char> valid(requests.size(), 0);
+
+    const auto seats = clubSystem_.seats();
+    for(size_t i = 0; i < requests.size(); ++i) {
+        const Request& request = requests[i];
+        try {
+            const TimeSlot slot{request.start, request.end};
+            validate_time_slot(slot);
+
+            const Seat* seat = seats->find(request.seat_id);
+            if(!seat) throw std::runtime_error("Seat not found");
+            clubSystem_.get_client(request.client_id);
+
+            prices[i] = calculate_price(*seat, slot);
+            valid[i] = 1;
+        } catch(const std::exception& e) {
+            results[i].error = e.what();
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(schedule_mutex_);
+
+    // Принятые запросы пакета; временные id отрицательные, чтобы не
+    // совпасть с настоящими
+    SeatSchedule batch;
+    std::vector<size_t> accepted;
+    for(size_t i = 0; i < requests.size(); ++i) {
+        if(!valid[i]) continue;
+        const Request& request = requests[i];
+        if(!schedule_.is_free(request.seat_id, request.start, request.end)) {
+            results[i].error = "Место недоступно для бронирования";
+        } else if(!batch.is_free(request.seat_id, request.start, request.end)) {
+            results[i].error = "Пересекается с другим запросом пакета";
+        } else {
+            batch.add(request.seat_id, -static_cast<int>(i) - 1, request.start, request.end);
+            accepted.push_back(i);
+        }
+    }
+    if(accepted.empty()) return results;
+
+    // 0 - строку отклонила БД, ошибка записана в результат
+    std::vector<int> ids(accepted.size(), 0);
+    // transaction() удерживает соединение: запросы других потоков не
+    // попадут в транзакцию пакета. Каждая строка - в своей точке сохранения:
+    // отказ по данным строки (например, внешний ключ) откатывает только её,
+    // а ошибка уровня БД (занятость, ввод-вывод) - весь пакет.
+    try {
+        db_.transaction([&] {
+            for(size_t k = 0; k < accepted.size(); ++k) {
+                const size_t i = accepted[k];
+                const Request& request = requests[i];
+                db_.execute("SAVEPOINT batch_row");
+                try {
+                    ids[k] = static_cast<int>(db_.insert(
+                        "INSERT INTO reservations (client_id, seat_id, start_time, end_time, status, total_cost) "
+                        "VALUES (?, ?, ?, ?, ?, ?)",
+                        {
+                            request.client_id,
+                            request.seat_id,
+                            request.start,
+                            request.end,
+                            static_cast<int>(Reservation::Status::Pending),
+                            prices[i]
+                        }
+                    ));
+                } catch(const DatabaseManager::Error& e) {
+                    if(!e.row_error()) throw;
+                    results[i].error = e.what();
+                    db_.execute("ROLLBACK TO batch_row");
+                }
+                db_.execute("RELEASE batch_row");
+            }
+        });
+    } catch(const std::exception& e) {
+        for(size_t i : accepted) results[i].error = e.what();
+        return results;
+    }
+
+    std::vector<int> reserved_seats;
+    {
+        std::unique_lock<std::shared_mutex> store_lock(store_mutex_);
+        for(size_t k = 0; k < accepted.size(); ++k) {
+            if(ids[k] == 0) continue;
+            const size_t i = accepted[k];
+            const Request& request = requests[i];
+            schedule_.add(request.seat_id, ids[k], request.start, request.end);
+            results[i].reservation.emplace(ids[k], request.client_id, request.seat_id,
+                                           request.start, request.end,
+                                           Reservation::Status::Pending, prices[i]);
+            store_.upsert(*results[i].reservation);
+            reserved_seats.push_back(request.seat_id);
+        }
+    }
+    lock.unlock();
+
+    std::sort(reserved_seats.begin(), reserved_seats.end());
+    reserved_seats.erase(std::unique(reserved_seats.begin(), reserved_seats.end()),
+                         reserved_seats.end());
+    for(int seat_id : reserved_seats) {
+        clubSystem_.update_seat_status(seat_id, Seat::Status::Reserved);
+    }
+
+    return results;
 }
 
 double ReservationManager::calculate_price(const Seat& seat, const TimeSlot& slot) {
-    double minutes = difftime(slot.end, slot.start) / 60;
-    return minutes * 2.0; 
+    {
+        std::shared_lock<std::shared_mutex> lock(pricing_mutex_);
+        if(pricing_.covers(slot.start, slot.end)) {
+            return pricing_.price(seat.type(), slot.start, slot.end);
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(pricing_mutex_);
+    if(!pricing_.covers(slot.start, slot.end)) {
+        const auto& breakpoints = pricing_.breakpoints();
+        pricing_.compile(std::min(breakpoints.front(), slot.start - pricing_margin),
+                         std::max(breakpoints.back(), slot.end + pricing_margin));
+    }
+    return pricing_.price(seat.type(), slot.start, slot.end);
+}
+
+std::vector<double> ReservationManager::calculate_prices(const PricingEngine::BatchColumns& batch) {
+    if(batch.end.size() != batch.start.size()) {
+        throw std::invalid_argument("Batch columns must have equal length");
+    }
+    if(batch.start.empty()) return {};
+    const auto [first, last] = std::minmax_element(batch.start.begin(), batch.start.end());
+    const time_t from = *first;
+    const time_t to = std::max(*last, *std::max_element(batch.end.begin(), batch.end.end()));
+
+    {
+        std::shared_lock<std::shared_mutex> lock(pricing_mutex_);
+        if(pricing_.covers(from, to)) {
+            return pricing_.price_batch(batch);
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(pricing_mutex_);
+    if(!pricing_.covers(from, to)) {
+        const auto& breakpoints = pricing_.breakpoints();
+        pricing_.compile(std::min(breakpoints.front(), from - pricing_margin),
+                         std::max(breakpoints.back(), to + pricing_margin));
+    }
+    return pricing_.price_batch(batch);
+}
+
+ReservationManager::Repricing ReservationManager::reprice_reservations(Reservation::Status status) {
+    const auto seats = clubSystem_.seats();
+    Repricing result;
+    PricingEngine::BatchColumns batch;
+    {
+        std::shared_lock<std::shared_mutex> lock(store_mutex_);
+        const size_t expected = status == Reservation::Status::ANY ? store_.size() : 0;
+        result.ids.reserve(expected);
+        batch.start.reserve(expected);
+        batch.end.reserve(expected);
+        batch.seat_type.reserve(expected);
+        store_.for_each(-1, -1, status, [&](const Reservation& r) {
+            const Seat* seat = seats->find(r.seat_id());
+            if(!seat) return;
+            result.ids.push_back(r.id());
+            batch.start.push_back(r.start_time());
+            batch.end.push_back(r.end_time());
+            batch.seat_type.push_back(static_cast<int32_t>(seat->type()));
+        });
+    }
+    result.prices = calculate_prices(batch);
+    return result;
 }
 
 int ReservationManager::get_last_insert_id() const {
-    auto result = db_.fetch_all("SELECT last_insert_rowid()");
-    return std::stoi(result[0].columns[0]);
+    return static_cast<int>(db_.last_insert_id());
 }
 
 void ReservationManager::cancel_reservation(int reservation_id) {
     Reservation res = load_reservation(reservation_id);
     res.cancel();
     save_reservation(res);
+    {
+        std::lock_guard<std::mutex> lock(schedule_mutex_);
+        schedule_.remove(res.seat_id(), res.id(), res.start_time());
+    }
     
     clubSystem_.update_seat_status(res.seat_id(), Seat::Status::Free);
 }
 
-std::vector<Reservation> ReservationManager::find_reservations(int client_id, int seat_id, 
-                                                             Reservation::Status status) const {
-    std::vector<std::string> conditions;
-    std::vector<std::string> params;
-    
-    if(client_id != -1) {
-        conditions.push_back("client_id = ?");
-        params.push_back(std::to_string(client_id));
-    }
-    if(seat_id != -1) {
-        conditions.push_back("seat_id = ?");
-        params.push_back(std::to_string(seat_id));
-    }
-    if(status != Reservation::Status::ANY) {
-        conditions.push_back("status = ?");
-        params.push_back(std::to_string(static_cast<int>(status)));
+void ReservationManager::complete_reservation(int reservation_id) {
+    Reservation res = load_reservation(reservation_id);
+    res.complete();
+    save_reservation(res);
+    {
+        std::lock_guard<std::mutex> lock(schedule_mutex_);
+        schedule_.remove(res.seat_id(), res.id(), res.start_time());
     }
 
-    std::string query = "SELECT id, client_id, seat_id, start_time, end_time, status, total_cost "
-                       "FROM reservations";
-    
-    if(!conditions.empty()) {
-        query += " WHERE " + join_strings(conditions, " AND ");
-    }
+    clubSystem_.update_seat_status(res.seat_id(), Seat::Status::Free);
+}
 
+void ReservationManager::load() {
+    ReservationStore store;
+    SeatSchedule schedule;
+    db_.reader().for_each_row(
+        "SELECT id, client_id, seat_id, start_time, end_time, status, total_cost "
+        "FROM reservations ORDER BY id", {},
+        [&store, &schedule](const DatabaseManager::Row& row) {
+            const Reservation reservation = create_from_db_row(row);
+            store.upsert(reservation);
+            if(reservation.status() == Reservation::Status::Pending ||
+               reservation.status() == Reservation::Status::Active) {
+                schedule.add(reservation.seat_id(), reservation.id(),
+                             reservation.start_time(), reservation.end_time());
+            }
+        }
+    );
+    std::lock_guard<std::mutex> lock(schedule_mutex_);
+    schedule_ = std::move(schedule);
+    std::unique_lock<std::shared_mutex> store_lock(store_mutex_);
+    store_ = std::move(store);
+}
+
+std::vector<Reservation> ReservationManager::find_reservations(int client_id, int seat_id, 
+                                                             Reservation::Status status) const {
     std::vector<Reservation> result;
-    auto rows = db_.fetch_all(query, params);
-    
-    for(const auto& row : rows) {
-        result.push_back(create_from_db_row(row.columns));
-    }
-    
+    for_each_reservation(client_id, seat_id, status, [&result](const Reservation& r) {
+        result.push_back(r);
+    });
     return result;
 }
 
-bool ReservationManager::is_available(int seat_id, const TimeSlot& slot) const {
-    auto rows = db_.fetch_all(
-        "SELECT COUNT(*) FROM reservations "
-        "WHERE seat_id = ? "
-        "AND ((start_time BETWEEN ? AND ?) OR (end_time BETWEEN ? AND ?)) "
-        "AND status IN (0, 1)",
-        {
-            std::to_string(seat_id),
-            std::to_string(slot.start),
-            std::to_string(slot.end),
-            std::to_string(slot.start),
-            std::to_string(slot.end)
-        }
-    );
+void ReservationManager::for_each_reservation(int client_id, int seat_id,
+                                              Reservation::Status status,
+                                              const std::function<void(const Reservation&)>& fn) const {
+    std::shared_lock<std::shared_mutex> lock(store_mutex_);
+    store_.for_each(client_id, seat_id, status, fn);
+}
 
-    return rows.empty() || std::stoi(rows[0].columns[0]) == 0;
+ReservationManager::Page ReservationManager::query_reservations(const Query& query) const {
+    std::shared_lock<std::shared_mutex> lock(store_mutex_);
+    return store_.query(query);
 }
 
-Reservation ReservationManager::load_reservation(int id) const {
-    auto rows = db_.fetch_all(
-        "SELECT id, client_id, seat_id, start_time, end_time, status, total_cost "
-        "FROM reservations WHERE id = ?",
-        {std::to_string(id)}
-    );
+bool ReservationManager::is_available(int seat_id, const TimeSlot& slot) const {
+    std::lock_guard<std::mutex> lock(schedule_mutex_);
+    return schedule_.is_free(seat_id, slot.start, slot.end);
+}
 
-    if(rows.empty()) {
+Reservation ReservationManager::load_reservation(int id) const {
+    std::shared_lock<std::shared_mutex> lock(store_mutex_);
+    const Reservation* reservation = store_.find(id);
+    if(!reservation) {
         throw std::runtime_error("Reservation not found");
     }
-    
-    return create_from_db_row(rows[0].columns);
+    return *reservation;
 }
 
 void ReservationManager::save_reservation(const Reservation& r) {
-    db_.execute(
-        "UPDATE reservations SET "
-        "client_id = ?, seat_id = ?, start_time = ?, end_time = ?, "
-        "status = ?, total_cost = ? "
-        "WHERE id = ?",
-        {
-            std::to_string(r.client_id()),
-            std::to_string(r.seat_id()),
-            std::to_string(r.start_time()),
-            std::to_string(r.end_time()),
-            std::to_string(static_cast<int>(r.status())),
-            std::to_string(r.total_cost()),
-            std::to_string(r.id())
-        }
-    );
+    // Билет ждётся без блокировок: одновременные изменения попадают в одну
+    // порцию, а порядок в памяти восстанавливается по номеру
+    DatabaseManager::WriteTicket ticket;
+    uint64_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(submit_mutex_);
+        ticket = db_.submit(
+            "UPDATE reservations SET "
+            "client_id = ?, seat_id = ?, start_time = ?, end_time = ?, "
+            "status = ?, total_cost = ? "
+            "WHERE id = ?",
+            {
+                r.client_id(),
+                r.seat_id(),
+                r.start_time(),
+                r.end_time(),
+                static_cast<int>(r.status()),
+                r.total_cost(),
+                r.id()
+            }
+        );
+        sequence = ++write_sequence_;
+    }
+    ticket.get();
+    std::unique_lock<std::shared_mutex> lock(store_mutex_);
+    uint64_t& applied = applied_writes_[r.id()];
+    if(applied > sequence) return;
+    applied = sequence;
+    store_.upsert(r);
 }
 
-Reservation ReservationManager::create_from_db_row(const std::vector<std::string>& row) {
+Reservation ReservationManager::create_from_db_row(const DatabaseManager::Row& row) {
     return Reservation(
-        std::stoi(row[0]),
-        std::stoi(row[1]),
-        std::stoi(row[2]),
-        std::stol(row[3]),
-        std::stol(row[4]),
-        static_cast<Reservation::Status>(std::stoi(row[5])),
-        std::stod(row[6])
+        row.get_int(0),
+        row.get_int(1),
+        row.get_int(2),
+        static_cast<time_t>(row.get_int64(3)),
+        static_cast<time_t>(row.get_int64(4)),
+        static_cast<Reservation::Status>(row.get_int(5)),
+        row.get_double(6)
     );
 }
 
-std::string ReservationManager::join_strings(const std::vector<std::string>& vec, 
-                                           const std::string& delimiter) const {
-    std::string result;
-    for(size_t i = 0; i < vec.size(); ++i) {
-        if(i > 0) result += delimiter;
-        result += vec[i];
-    }
-    return result;
-}
-
 void ReservationManager::validate_time_slot(const TimeSlot& slot) const {
     if(slot.start >= slot.end) {
         throw std::invalid_argument("End time must be after start time");
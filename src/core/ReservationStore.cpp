@@ -0,0 +1,166 @@
+#include "../../include/core/ReservationStore.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+    const ReservationStore::Index empty_index;
+}
+
+void ReservationStore::clear() {
+    reservations_.clear();
+    by_client_.clear();
+    by_seat_.clear();
+    for(auto& index : by_status_) index.clear();
+    by_start_.clear();
+    max_duration_ = 0;
+}
+
+void ReservationStore::reserve(size_t count) {
+    reservations_.reserve(count);
+}
+
+void ReservationStore::upsert(const Reservation& reservation) {
+    if(const Reservation* existing = reservations_.find(reservation.id())) {
+        unindex(*existing);
+    }
+    reservations_.insert_or_assign(reservation.id(), reservation);
+    index(reservation);
+}
+
+const Reservation* ReservationStore::find(int id) const noexcept {
+    return reservations_.find(id);
+}
+
+size_t ReservationStore::size() const noexcept {
+    return reservations_.size();
+}
+
+void ReservationStore::index(const Reservation& reservation) {
+    const Key key{reservation.start_time(), reservation.id()};
+    by_client_[reservation.client_id()].insert(key);
+    by_seat_[reservation.seat_id()].insert(key);
+    by_start_.insert(key);
+    max_duration_ = std::max(max_duration_, reservation.end_time() - reservation.start_time());
+
+    const auto status = static_cast<size_t>(reservation.status());
+    if(status < status_count) by_status_[status].insert(key);
+}
+
+void ReservationStore::unindex(const Reservation& reservation) {
+    const Key key{reservation.start_time(), reservation.id()};
+
+    auto client = by_client_.find(reservation.client_id());
+    if(client != by_client_.end()) {
+        client->second.erase(key);
+        if(client->second.empty()) by_client_.erase(client);
+    }
+
+    auto seat = by_seat_.find(reservation.seat_id());
+    if(seat != by_seat_.end()) {
+        seat->second.erase(key);
+        if(seat->second.empty()) by_seat_.erase(seat);
+    }
+
+    by_start_.erase(key);
+
+    const auto status = static_cast<size_t>(reservation.status());
+    if(status < status_count) by_status_[status].erase(key);
+}
+
+const ReservationStore::Index* ReservationStore::lookup(
+        const std::unordered_map<int, Index>& indexes, int key) {
+    auto it = indexes.find(key);
+    return it == indexes.end() ? &empty_index : &it->second;
+}
+
+const ReservationStore::Index* ReservationStore::narrowest_index(int client_id,
+                                                                 int seat_id,
+                                                                 Reservation::Status status) const {
+    const Index* narrowest = nullptr;
+    const auto consider = [&narrowest](const Index* index) {
+        if(!narrowest || index->size() < narrowest->size()) narrowest = index;
+    };
+    if(client_id != -1) consider(lookup(by_client_, client_id));
+    if(seat_id != -1) consider(lookup(by_seat_, seat_id));
+    if(status != Reservation::Status::ANY) consider(&by_status_[static_cast<size_t>(status)]);
+    return narrowest;
+}
+
+void ReservationStore::for_each(int client_id,
+                                int seat_id,
+                                Reservation::Status status,
+                                const std::function<void(const Reservation&)>& fn) const {
+    const Index* narrowest = narrowest_index(client_id, seat_id, status);
+    if(!narrowest) {
+        for(const auto& r : reservations_) fn(r);
+        return;
+    }
+
+    for(const auto& [start, id] : *narrowest) {
+        const Reservation& r = *reservations_.find(id);
+        if((client_id == -1 || r.client_id() == client_id) &&
+           (seat_id == -1 || r.seat_id() == seat_id) &&
+           (status == Reservation::Status::ANY || r.status() == status)) {
+            fn(r);
+        }
+    }
+}
+
+ReservationStore::Page ReservationStore::query(const Query& q) const {
+    Page page;
+    if(q.limit == 0) return page;
+
+    const Index* narrowest = narrowest_index(q.client_id, q.seat_id, q.status);
+    const Index& index = narrowest ? *narrowest : by_start_;
+
+    const auto matches = [&q](const Reservation& r) {
+        return (q.client_id == -1 || r.client_id() == q.client_id) &&
+               (q.seat_id == -1 || r.seat_id() == q.seat_id) &&
+               (q.status == Reservation::Status::ANY || r.status() == q.status) &&
+               (q.from == 0 || r.end_time() > q.from) &&
+               (q.to == 0 || r.start_time() < q.to);
+    };
+
+    // Бронь пересекает окно, только если началась не раньше from - max_duration_
+    constexpr int min_id = std::numeric_limits<int>::min();
+    const bool bounded_below = q.from != 0;
+    const Key lowest{q.from - max_duration_, min_id};
+    const bool has_cursor = q.after_id >= 0;
+    const Key cursor{q.after_start, q.after_id};
+
+    const auto take = [&](const Key& key) {
+        const Reservation& r = *reservations_.find(key.second);
+        if(!matches(r)) return true;
+        if(page.items.size() == q.limit) {
+            page.has_more = true;
+            return false;
+        }
+        page.items.push_back(r);
+        return true;
+    };
+
+    if(q.order == Order::StartAsc) {
+        auto it = index.begin();
+        if(bounded_below) it = index.lower_bound(lowest);
+        if(has_cursor && it != index.end() && *it <= cursor) it = index.upper_bound(cursor);
+
+        for(; it != index.end(); ++it) {
+            if(q.to != 0 && it->first >= q.to) break;
+            if(!take(*it)) break;
+        }
+    } else {
+        auto it = index.end();
+        if(q.to != 0) it = index.lower_bound(Key{q.to, min_id});
+        if(has_cursor) {
+            auto after = index.lower_bound(cursor);
+            if(it == index.end() || (after != index.end() && *after < *it)) it = after;
+        }
+
+        while(it != index.begin()) {
+            --it;
+            if(bounded_below && *it < lowest) break;
+            if(!take(*it)) break;
+        }
+    }
+    return page;
+}
@@ -0,0 +1,305 @@
+#include "../../include/core/SalesLedger.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+constexpr size_t rows_per_insert = 128;
+
+int64_t hour_of(time_t t) noexcept {
+    return static_cast<int64_t>(t / 3600);
+}
+
+// Начало местных суток, содержащих t, и (если нужно) начало следующих
+time_t local_day_start(time_t t, time_t* next = nullptr) {
+    std::tm local{};
+    localtime_r(&t, &local);
+    local.tm_hour = local.tm_min = local.tm_sec = 0;
+    local.tm_isdst = -1;
+    std::tm day = local;
+    const time_t begin = std::mktime(&day);
+    if(next) {
+        local.tm_mday += 1;
+        *next = std::mktime(&local);
+    }
+    return begin;
+}
+
+std::string insert_sql(size_t rows) {
+    std::string sql = "INSERT INTO sales (product_id, client_id, quantity, amount, sold_at) VALUES ";
+    for(size_t i = 0; i < rows; ++i) {
+        if(i) sql += ", ";
+        sql += "(?, ?, ?, ?, ?)";
+    }
+    return sql;
+}
+
+}
+
+SalesLedger::SalesLedger(DatabaseManager& db) : db_(db), ring_(capacity) {}
+
+SalesLedger::~SalesLedger() {
+    stop_flusher();
+}
+
+void SalesLedger::add(Totals& totals, int64_t sales, int64_t quantity, double revenue) noexcept {
+    totals.sales += sales;
+    totals.quantity += quantity;
+    totals.revenue += revenue;
+}
+
+void SalesLedger::load() {
+    auto& reader = db_.reader();
+    std::lock_guard<std::mutex> lock(mutex_);
+    total_ = {};
+    by_product_.clear();
+    by_hour_.clear();
+    by_day_.clear();
+
+    reader.for_each_row(
+        "SELECT product_id, COUNT(*), SUM(quantity), SUM(amount) FROM sales GROUP BY product_id", {},
+        [this](const DatabaseManager::Row& row) {
+            add(by_product_[row.get_int(0)], row.get_int64(1), row.get_int64(2), row.get_double(3));
+            add(total_, row.get_int64(1), row.get_int64(2), row.get_double(3));
+        }
+    );
+    reader.for_each_row(
+        "SELECT sold_at / 3600, COUNT(*), SUM(quantity), SUM(amount) FROM sales GROUP BY 1", {},
+        [this](const DatabaseManager::Row& row) {
+            add(by_hour_[row.get_int64(0)], row.get_int64(1), row.get_int64(2), row.get_double(3));
+        }
+    );
+    // Границы местных суток считает SQLite по той же базе часовых поясов
+    reader.for_each_row(
+        "SELECT CAST(strftime('%s', date(sold_at, 'unixepoch', 'localtime'), 'utc') AS INTEGER) AS day, "
+        "COUNT(*), SUM(quantity), SUM(amount) FROM sales GROUP BY day", {},
+        [this](const DatabaseManager::Row& row) {
+            add(by_day_[static_cast<time_t>(row.get_int64(0))],
+                row.get_int64(1), row.get_int64(2), row.get_double(3));
+        }
+    );
+}
+
+void SalesLedger::start() {
+    stop_flusher();
+    stop_ = false;
+    flusher_ = std::thread(&SalesLedger::flusher_loop, this);
+}
+
+void SalesLedger::stop() {
+    stop_flusher();
+    write_pending();
+}
+
+void SalesLedger::set_reject_handler(RejectHandler handler) {
+    on_reject_ = std::move(handler);
+}
+
+void SalesLedger::stop_flusher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    flush_cv_.notify_all();
+    if(flusher_.joinable()) flusher_.join();
+}
+
+void SalesLedger::flusher_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool failing = false;
+    while(!stop_) {
+        flush_cv_.wait_for(lock, max_delay, [this] {
+            return stop_ || head_ - tail_ >= batch_size;
+        });
+        if(stop_ || head_ == tail_) continue;
+
+        lock.unlock();
+        bool failed = false;
+        try {
+            write_pending();
+        } catch(const std::exception& error) {
+            // Продажи остаются в кольце и будут записаны следующей попыткой
+            if(!failing) std::cerr << "Журнал продаж: не удалось записать порцию: " << error.what() << "\n";
+            failed = true;
+        }
+        failing = failed;
+        lock.lock();
+        if(failed) flush_cv_.wait_for(lock, max_delay, [this] { return stop_; });
+    }
+}
+
+void SalesLedger::record(const Sale& sale) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if(head_ - tail_ == ring_.size()) {
+        // Фоновая запись не успевает: освобождаем место сами
+        lock.unlock();
+        write_pending();
+        lock.lock();
+        if(head_ - tail_ == ring_.size()) {
+            throw std::runtime_error("Sales ledger is full");
+        }
+    }
+
+    ring_[head_ % ring_.size()] = sale;
+    ++head_;
+
+    add(total_, 1, sale.quantity, sale.amount);
+    add(by_product_[sale.product_id], 1, sale.quantity, sale.amount);
+    add(by_hour_[hour_of(sale.sold_at)], 1, sale.quantity, sale.amount);
+    add(by_day_[day_of(sale.sold_at)], 1, sale.quantity, sale.amount);
+
+    if(head_ - tail_ >= batch_size) flush_cv_.notify_one();
+}
+
+void SalesLedger::flush() {
+    std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+    std::vector<Sale> sales;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sales.reserve(static_cast<size_t>(head_ - tail_));
+        for(uint64_t i = tail_; i != head_; ++i) {
+            sales.push_back(ring_[i % ring_.size()]);
+        }
+    }
+    if(sales.empty()) return;
+
+    write(sales);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    tail_ += sales.size();
+}
+
+// Порцию отклонила строка: продажи пишутся по одной, чтобы отказ получили
+// только виновные. Временная ошибка БД останавливает проход, продажи с
+// этого места остаются в кольце.
+void SalesLedger::write_pending() {
+    try {
+        flush();
+    } catch(const DatabaseManager::Error& error) {
+        if(!error.row_error()) throw;
+        flush_each();
+    }
+}
+
+void SalesLedger::flush_each() {
+    std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+    std::vector<Sale> sales;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for(uint64_t i = tail_; i != head_; ++i) {
+            sales.push_back(ring_[i % ring_.size()]);
+        }
+    }
+
+    size_t done = 0;
+    std::vector<Rejected> failed;
+    try {
+        for(; done < sales.size(); ++done) {
+            try {
+                write({sales[done]});
+            } catch(const DatabaseManager::Error& error) {
+                if(!error.row_error()) throw;
+                failed.push_back({sales[done], error.what()});
+            }
+        }
+    } catch(...) {
+        reject(failed, done);
+        throw;
+    }
+    reject(failed, done);
+}
+
+// Снимает обработанные продажи с кольца, отклонённые вычитает из итогов
+void SalesLedger::reject(const std::vector<Rejected>& failed, size_t done) {
+    // Списание возвращается до сдвига хвоста: когда pending() дошёл до нуля,
+    // отклонённая продажа уже отменена полностью
+    for(const Rejected& rejected : failed) {
+        std::cerr << "Журнал продаж: продажа товара " << rejected.sale.product_id
+                  << " (" << rejected.sale.quantity << " шт.) отклонена: " << rejected.error << "\n";
+        if(on_reject_) on_reject_(rejected.sale);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    for(const Rejected& rejected : failed) {
+        const Sale& sale = rejected.sale;
+        add(total_, -1, -sale.quantity, -sale.amount);
+        add(by_product_[sale.product_id], -1, -sale.quantity, -sale.amount);
+        add(by_hour_[hour_of(sale.sold_at)], -1, -sale.quantity, -sale.amount);
+        add(by_day_[day_of(sale.sold_at)], -1, -sale.quantity, -sale.amount);
+        rejected_.push_back(rejected);
+    }
+    tail_ += done;
+}
+
+void SalesLedger::write(const std::vector<Sale>& sales) {
+    // Списание суммируется по товарам: один UPDATE на товар в порции
+    std::unordered_map<int, int64_t> sold;
+    for(const Sale& sale : sales) sold[sale.product_id] += sale.quantity;
+
+    db_.transaction([&] {
+        std::vector<DatabaseManager::Value> params;
+        for(size_t at = 0; at < sales.size(); at += rows_per_insert) {
+            const size_t rows = std::min(rows_per_insert, sales.size() - at);
+            params.clear();
+            for(size_t k = 0; k < rows; ++k) {
+                const Sale& sale = sales[at + k];
+                params.emplace_back(sale.product_id);
+                if(sale.client_id > 0) {
+                    params.emplace_back(sale.client_id);
+                } else {
+                    params.emplace_back(nullptr);
+                }
+                params.emplace_back(sale.quantity);
+                params.emplace_back(sale.amount);
+                params.emplace_back(sale.sold_at);
+            }
+            db_.execute(insert_sql(rows), params);
+        }
+        for(const auto& [product_id, quantity] : sold) {
+            db_.execute("UPDATE products SET stock = stock - ? WHERE id = ?",
+                        {static_cast<long long>(quantity), product_id});
+        }
+    });
+}
+
+time_t SalesLedger::day_of(time_t t) {
+    if(t < day_begin_ || t >= day_end_) {
+        day_begin_ = local_day_start(t, &day_end_);
+    }
+    return day_begin_;
+}
+
+size_t SalesLedger::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(head_ - tail_);
+}
+
+std::vector<SalesLedger::Rejected> SalesLedger::rejected() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rejected_;
+}
+
+SalesLedger::Totals SalesLedger::total() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return total_;
+}
+
+SalesLedger::Totals SalesLedger::product_totals(int product_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = by_product_.find(product_id);
+    return it == by_product_.end() ? Totals{} : it->second;
+}
+
+SalesLedger::Totals SalesLedger::hour_totals(time_t t) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = by_hour_.find(hour_of(t));
+    return it == by_hour_.end() ? Totals{} : it->second;
+}
+
+SalesLedger::Totals SalesLedger::day_totals(time_t t) const {
+    const time_t day = local_day_start(t);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = by_day_.find(day);
+    return it == by_day_.end() ? Totals{} : it->second;
+}
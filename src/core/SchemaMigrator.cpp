@@ -0,0 +1,137 @@
+#include "../../include/core/SchemaMigrator.h"
+
+SchemaMigrator::SchemaMigrator(DatabaseManager& db) : db_(db) {}
+
+const std::vector<SchemaMigrator::Migration>& SchemaMigrator::migrations() {
+    static const std::vector<Migration> list = {
+        {1, {
+            R"(CREATE TABLE IF NOT EXISTS clients (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                name TEXT NOT NULL,
+                contact TEXT UNIQUE NOT NULL,
+                reg_date INTEGER NOT NULL))",
+
+            R"(CREATE TABLE IF NOT EXISTS seats (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                type INTEGER NOT NULL,
+                status INTEGER NOT NULL,
+                hardware_spec TEXT))",
+
+            R"(CREATE TABLE IF NOT EXISTS products (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                name TEXT NOT NULL,
+                category INTEGER NOT NULL,
+                price REAL NOT NULL,
+                stock INTEGER DEFAULT 0))",
+
+            R"(CREATE TABLE IF NOT EXISTS reservations (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                client_id INTEGER NOT NULL,
+                seat_id INTEGER NOT NULL,
+                start_time INTEGER NOT NULL,
+                end_time INTEGER NOT NULL,
+                status INTEGER NOT NULL,
+                total_cost REAL NOT NULL,
+                FOREIGN KEY(client_id) REFERENCES clients(id),
+                FOREIGN KEY(seat_id) REFERENCES seats(id)))"
+        }},
+        {2, {
+            "CREATE INDEX IF NOT EXISTS idx_reservations_seat_time "
+            "ON reservations(seat_id, start_time, end_time)",
+            "CREATE INDEX IF NOT EXISTS idx_reservations_client "
+            "ON reservations(client_id)",
+            "CREATE INDEX IF NOT EXISTS idx_reservations_status "
+            "ON reservations(status)"
+        }},
+        // Счётчик изменений мест, клиентов и товаров: по нему проверяется
+        // актуальность бинарного снимка. UPDATE без фактических изменений
+        // (например, save_data) счётчик не увеличивает.
+        {3, {
+            R"(CREATE TABLE IF NOT EXISTS meta (
+                key TEXT PRIMARY KEY,
+                value INTEGER NOT NULL))",
+            "INSERT OR IGNORE INTO meta (key, value) VALUES ('generation', 0)",
+
+            R"(CREATE TRIGGER IF NOT EXISTS seats_generation_insert AFTER INSERT ON seats
+               BEGIN UPDATE meta SET value = value + 1 WHERE key = 'generation'; END)",
+            R"(CREATE TRIGGER IF NOT EXISTS seats_generation_update AFTER UPDATE ON seats
+               WHEN OLD.id IS NOT NEW.id OR OLD.type IS NOT NEW.type
+                 OR OLD.status IS NOT NEW.status OR OLD.hardware_spec IS NOT NEW.hardware_spec
+               BEGIN UPDATE meta SET value = value + 1 WHERE key = 'generation'; END)",
+            R"(CREATE TRIGGER IF NOT EXISTS seats_generation_delete AFTER DELETE ON seats
+               BEGIN UPDATE meta SET value = value + 1 WHERE key = 'generation'; END)",
+
+            R"(CREATE TRIGGER IF NOT EXISTS clients_generation_insert AFTER INSERT ON clients
+               BEGIN UPDATE meta SET value = value + 1 WHERE key = 'generation'; END)",
+            R"(CREATE TRIGGER IF NOT EXISTS clients_generation_update AFTER UPDATE ON clients
+               WHEN OLD.id IS NOT NEW.id OR OLD.name IS NOT NEW.name
+                 OR OLD.contact IS NOT NEW.contact OR OLD.reg_date IS NOT NEW.reg_date
+               BEGIN UPDATE meta SET value = value + 1 WHERE key = 'generation'; END)",
+            R"(CREATE TRIGGER IF NOT EXISTS clients_generation_delete AFTER DELETE ON clients
+               BEGIN UPDATE meta SET value = value + 1 WHERE key = 'generation'; END)",
+
+            R"(CREATE TRIGGER IF NOT EXISTS products_generation_insert AFTER INSERT ON products
+               BEGIN UPDATE meta SET value = value + 1 WHERE key = 'generation'; END)",
+            R"(CREATE TRIGGER IF NOT EXISTS products_generation_update AFTER UPDATE ON products
+               WHEN OLD.id IS NOT NEW.id OR OLD.name IS NOT NEW.name
+                 OR OLD.category IS NOT NEW.category OR OLD.price IS NOT NEW.price
+                 OR OLD.stock IS NOT NEW.stock
+               BEGIN UPDATE meta SET value = value + 1 WHERE key = 'generation'; END)",
+            R"(CREATE TRIGGER IF NOT EXISTS products_generation_delete AFTER DELETE ON products
+               BEGIN UPDATE meta SET value = value + 1 WHERE key = 'generation'; END)"
+        }},
+        // Журнал продаж: пишется порциями из SalesLedger вместе со списанием
+        // остатков. client_id = NULL - продажа без клиента.
+        {4, {
+            R"(CREATE TABLE IF NOT EXISTS sales (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                product_id INTEGER NOT NULL,
+                client_id INTEGER,
+                quantity INTEGER NOT NULL,
+                amount REAL NOT NULL,
+                sold_at INTEGER NOT NULL,
+                FOREIGN KEY(product_id) REFERENCES products(id),
+                FOREIGN KEY(client_id) REFERENCES clients(id)))",
+            "CREATE INDEX IF NOT EXISTS idx_sales_sold_at ON sales(sold_at)",
+            "CREATE INDEX IF NOT EXISTS idx_sales_product ON sales(product_id)"
+        }}
+    };
+    return list;
+}
+
+int SchemaMigrator::latest_version() {
+    return migrations().empty() ? 0 : migrations().back().version;
+}
+
+int SchemaMigrator::current_version() const {
+    auto rows = db_.fetch_all("PRAGMA user_version");
+    return rows.empty() ? 0 : rows[0].get_int(0);
+}
+
+int SchemaMigrator::migrate() {
+    const int version = current_version();
+    if(version >= latest_version()) return 0;
+
+    int applied = 0;
+    for(const auto& migration : migrations()) {
+        if(migration.version <= version) continue;
+        apply(migration);
+        ++applied;
+    }
+    return applied;
+}
+
+void SchemaMigrator::apply(const Migration& migration) {
+    try {
+        db_.transaction([&] {
+            for(const auto& sql : migration.statements) {
+                db_.execute(sql);
+            }
+            // PRAGMA не поддерживает параметры
+            db_.execute("PRAGMA user_version = " + std::to_string(migration.version));
+        });
+    } catch(const std::exception& e) {
+        throw std::runtime_error("Migration " + std::to_string(migration.version) +
+                                 " failed: " + e.what());
+    }
+}
@@ -0,0 +1,48 @@
+#include "../../include/core/SeatSchedule.h"
+
+void SeatSchedule::clear() noexcept {
+    seats_.clear();
+    size_ = 0;
+}
+
+void SeatSchedule::add(int seat_id, int reservation_id, time_t start, time_t end) {
+    Timeline& timeline = seats_[seat_id];
+    timeline.bookings.emplace(start, Booking{end, reservation_id});
+    if(end - start > timeline.max_duration) {
+        timeline.max_duration = end - start;
+    }
+    ++size_;
+}
+
+bool SeatSchedule::remove(int seat_id, int reservation_id, time_t start) {
+    auto seat = seats_.find(seat_id);
+    if(seat == seats_.end()) return false;
+
+    auto range = seat->second.bookings.equal_range(start);
+    for(auto it = range.first; it != range.second; ++it) {
+        if(it->second.reservation_id == reservation_id) {
+            seat->second.bookings.erase(it);
+            --size_;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SeatSchedule::is_free(int seat_id, time_t start, time_t end) const {
+    auto seat = seats_.find(seat_id);
+    if(seat == seats_.end()) return true;
+
+    // Пересекаться могут только брони, начавшиеся не раньше start - max_duration
+    const Timeline& timeline = seat->second;
+    auto first = timeline.bookings.upper_bound(start - timeline.max_duration);
+    auto last = timeline.bookings.lower_bound(end);
+    for(auto it = first; it != last; ++it) {
+        if(it->second.end > start) return false;
+    }
+    return true;
+}
+
+size_t SeatSchedule::size() const noexcept {
+    return size_;
+}
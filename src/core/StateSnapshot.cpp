@@ -0,0 +1,361 @@
+#include "../../include/core/StateSnapshot.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t seat_count;
+    uint32_t client_count;
+    uint32_t product_count;
+    int64_t generation;
+    uint64_t strings_size;
+    uint64_t checksum;
+};
+
+struct SeatRecord {
+    int32_t id;
+    int32_t type;
+    int32_t status;
+    uint32_t spec_len;
+    uint64_t spec_off;
+};
+
+struct ClientRecord {
+    int32_t id;
+    uint32_t name_len;
+    uint32_t contact_len;
+    uint32_t reserved;
+    uint64_t name_off;
+    uint64_t contact_off;
+    int64_t registered;
+};
+
+struct ProductRecord {
+    int32_t id;
+    int32_t category;
+    int32_t stock;
+    uint32_t name_len;
+    uint64_t name_off;
+    double price;
+};
+
+constexpr char magic[8] = {'C', 'L', 'U', 'B', 'S', 'N', 'A', 'P'};
+
+// FNV-1a по 8-байтовым словам: файл проверяется целиком при каждом запуске
+class Checksum {
+public:
+    void update(const char* data, size_t size) noexcept {
+        size_t i = 0;
+        for(; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            mix(word);
+        }
+        for(; i < size; ++i) {
+            mix(static_cast<unsigned char>(data[i]));
+        }
+    }
+
+    uint64_t value() const noexcept { return hash_; }
+
+private:
+    uint64_t hash_ = 14695981039346656037ULL;
+
+    void mix(uint64_t v) noexcept {
+        hash_ ^= v;
+        hash_ *= 1099511628211ULL;
+    }
+};
+
+class StringTable {
+public:
+    std::pair<uint64_t, uint32_t> add(const std::string& text) {
+        const uint64_t offset = data_.size();
+        data_.append(text);
+        return {offset, static_cast<uint32_t>(text.size())};
+    }
+
+    const std::string& data() const noexcept { return data_; }
+
+private:
+    std::string data_;
+};
+
+template<typename Record>
+void append_records(std::string& out, const std::vector<Record>& records) {
+    out.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(Record));
+}
+
+uint64_t checksum_of(Header header, const char* body, size_t body_size) {
+    header.checksum = 0;
+    Checksum sum;
+    sum.update(reinterpret_cast<const char*>(&header), sizeof(header));
+    sum.update(body, body_size);
+    return sum.value();
+}
+
+// Файл, отображённый в память только для чтения
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#ifndef _WIN32
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0) return;
+        struct stat info;
+        if(::fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* mapped = ::mmap(nullptr, static_cast<size_t>(info.st_size),
+                                  PROT_READ, MAP_PRIVATE, fd, 0);
+            if(mapped != MAP_FAILED) {
+                data_ = static_cast<const char*>(mapped);
+                size_ = static_cast<size_t>(info.st_size);
+            }
+        }
+        ::close(fd);
+#else
+        std::ifstream in(path, std::ios::binary);
+        if(!in) return;
+        buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+#endif
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if(data_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const noexcept { return data_; }
+    size_t size() const noexcept { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    std::vector<char> buffer_;
+#endif
+};
+
+// Сбрасывает на диск файл или каталог (в нём - запись о переименовании).
+// Без этого после сбоя питания rename может попасть на диск раньше данных,
+// и вместо прежнего снимка останется пустой или обрезанный файл.
+bool sync_to_disk(const std::string& path, bool directory) {
+#ifndef _WIN32
+    const int fd = ::open(path.c_str(), directory ? O_RDONLY | O_DIRECTORY : O_RDONLY);
+    if(fd < 0) return false;
+    const bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+#else
+    (void)path;
+    (void)directory;
+    return true;
+#endif
+}
+
+template<typename Record>
+Record record_at(const char* base, size_t index) noexcept {
+    Record record;
+    std::memcpy(&record, base + index * sizeof(Record), sizeof(Record));
+    return record;
+}
+
+}
+
+void StateSnapshot::write(const std::string& path,
+                          int64_t generation,
+                          const SeatMap& seats,
+                          const ClientMap& clients,
+                          const ProductMap& products) {
+    StringTable strings;
+
+    std::vector<SeatRecord> seat_records;
+    seat_records.reserve(seats.size());
+    for(const auto& seat : seats) {
+        const auto [offset, length] = strings.add(seat.hardware_spec());
+        seat_records.push_back({
+            seat.id(),
+            static_cast<int32_t>(seat.type()),
+            static_cast<int32_t>(seat.status()),
+            length,
+            offset
+        });
+    }
+
+    std::vector<ClientRecord> client_records;
+    client_records.reserve(clients.size());
+    for(const auto& client : clients) {
+        const auto [name_off, name_len] = strings.add(client.name());
+        const auto [contact_off, contact_len] = strings.add(client.contact());
+        client_records.push_back({
+            client.id(),
+            name_len,
+            contact_len,
+            0,
+            name_off,
+            contact_off,
+            static_cast<int64_t>(client.registered())
+        });
+    }
+
+    std::vector<ProductRecord> product_records;
+    product_records.reserve(products.size());
+    for(const auto& product : products) {
+        const auto [offset, length] = strings.add(product.name());
+        product_records.push_back({
+            product.id(),
+            static_cast<int32_t>(product.category()),
+            product.stock(),
+            length,
+            offset,
+            product.price()
+        });
+    }
+
+    std::string body;
+    body.reserve(seat_records.size() * sizeof(SeatRecord) +
+                 client_records.size() * sizeof(ClientRecord) +
+                 product_records.size() * sizeof(ProductRecord) +
+                 strings.data().size());
+    append_records(body, seat_records);
+    append_records(body, client_records);
+    append_records(body, product_records);
+    body.append(strings.data());
+
+    Header header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = format_version;
+    header.seat_count = static_cast<uint32_t>(seat_records.size());
+    header.client_count = static_cast<uint32_t>(client_records.size());
+    header.product_count = static_cast<uint32_t>(product_records.size());
+    header.generation = generation;
+    header.strings_size = strings.data().size();
+    header.checksum = checksum_of(header, body.data(), body.size());
+
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(body.data(), static_cast<std::streamsize>(body.size()));
+        out.close();
+        if(!out || !sync_to_disk(temp_path, false)) {
+            std::remove(temp_path.c_str());
+            throw std::runtime_error("Failed to write snapshot: " + temp_path);
+        }
+    }
+    if(std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        std::remove(temp_path.c_str());
+        throw std::runtime_error("Failed to replace snapshot: " + path);
+    }
+    const auto directory = std::filesystem::path(path).parent_path();
+    if(!sync_to_disk(directory.empty() ? "." : directory.string(), true)) {
+        throw std::runtime_error("Failed to sync snapshot directory: " + directory.string());
+    }
+}
+
+std::optional<StateSnapshot::Contents> StateSnapshot::read(const std::string& path,
+                                                           int64_t generation) {
+    MappedFile file(path);
+    if(!file.data() || file.size() < sizeof(Header)) return std::nullopt;
+
+    Header header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if(std::memcmp(header.magic, magic, sizeof(magic)) != 0 ||
+       header.version != format_version ||
+       header.generation != generation) {
+        return std::nullopt;
+    }
+
+    const uint64_t seats_size = uint64_t(header.seat_count) * sizeof(SeatRecord);
+    const uint64_t clients_size = uint64_t(header.client_count) * sizeof(ClientRecord);
+    const uint64_t products_size = uint64_t(header.product_count) * sizeof(ProductRecord);
+    const uint64_t body_size = seats_size + clients_size + products_size + header.strings_size;
+    if(body_size != file.size() - sizeof(Header)) return std::nullopt;
+
+    const char* body = file.data() + sizeof(Header);
+    if(checksum_of(header, body, body_size) != header.checksum) return std::nullopt;
+
+    const char* seat_base = body;
+    const char* client_base = seat_base + seats_size;
+    const char* product_base = client_base + clients_size;
+    const char* strings = product_base + products_size;
+
+    const auto text = [&](uint64_t offset, uint32_t length) -> std::optional<std::string> {
+        if(offset > header.strings_size || length > header.strings_size - offset) {
+            return std::nullopt;
+        }
+        return std::string(strings + offset, length);
+    };
+
+    SeatMap::Builder seats;
+    for(size_t i = 0; i < header.seat_count; ++i) {
+        const auto record = record_at<SeatRecord>(seat_base, i);
+        auto spec = text(record.spec_off, record.spec_len);
+        if(!spec || record.id < 0) return std::nullopt;
+
+        Seat seat(record.id,
+                  static_cast<Seat::Type>(record.type),
+                  static_cast<Seat::Status>(record.status));
+        seat.update_hardware(*spec);
+        seats.insert_or_assign(record.id, std::move(seat));
+    }
+
+    ClientMap::Builder clients;
+    for(size_t i = 0; i < header.client_count; ++i) {
+        const auto record = record_at<ClientRecord>(client_base, i);
+        auto name = text(record.name_off, record.name_len);
+        auto contact = text(record.contact_off, record.contact_len);
+        if(!name || !contact || record.id < 0) return std::nullopt;
+
+        clients.insert_or_assign(
+            record.id,
+            std::make_shared<const Client>(
+                Client::trusted,
+                record.id,
+                std::move(*name),
+                std::move(*contact),
+                static_cast<time_t>(record.registered)
+            )
+        );
+    }
+
+    ProductMap::Builder products;
+    for(size_t i = 0; i < header.product_count; ++i) {
+        const auto record = record_at<ProductRecord>(product_base, i);
+        auto name = text(record.name_off, record.name_len);
+        if(!name || record.id < 0) return std::nullopt;
+
+        products.insert_or_assign(
+            record.id,
+            Product(record.id,
+                    std::move(*name),
+                    static_cast<Product::Category>(record.category),
+                    record.price,
+                    record.stock)
+        );
+    }
+
+    Contents contents;
+    contents.seats = seats.build();
+    contents.clients = clients.build();
+    contents.products = products.build();
+    return contents;
+}
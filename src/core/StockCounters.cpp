@@ -0,0 +1,73 @@
+#include "../../include/core/StockCounters.h"
+#include <stdexcept>
+
+StockCounters::~StockCounters() {
+    for(auto& block : blocks_) {
+        delete block.load(std::memory_order_relaxed);
+    }
+}
+
+StockCounters::Counter* StockCounters::find(int product_id) const noexcept {
+    if(product_id < 0) return nullptr;
+    const auto index = static_cast<size_t>(product_id);
+    if(index / block_size >= directory_size) return nullptr;
+    Block* block = blocks_[index / block_size].load(std::memory_order_acquire);
+    return block ? &block->counters[index % block_size] : nullptr;
+}
+
+void StockCounters::set(int product_id, int stock) {
+    if(product_id < 0 || static_cast<size_t>(product_id) / block_size >= directory_size) {
+        throw std::out_of_range("Product id is out of stock counter range");
+    }
+    Counter* counter = find(product_id);
+    if(!counter) {
+        std::lock_guard<std::mutex> lock(grow_mutex_);
+        auto& slot = blocks_[static_cast<size_t>(product_id) / block_size];
+        if(!slot.load(std::memory_order_relaxed)) {
+            slot.store(new Block(), std::memory_order_release);
+        }
+        counter = find(product_id);
+    }
+    counter->on_hand.store(stock);
+    counter->available.store(stock);
+}
+
+bool StockCounters::reserve(int product_id, int quantity) noexcept {
+    Counter* counter = find(product_id);
+    if(!counter || quantity <= 0) return false;
+
+    int current = counter->available.load(std::memory_order_relaxed);
+    do {
+        if(current < quantity) return false;
+    } while(!counter->available.compare_exchange_weak(current, current - quantity));
+    return true;
+}
+
+void StockCounters::commit(int product_id, int quantity) noexcept {
+    if(Counter* counter = find(product_id)) {
+        counter->on_hand.fetch_sub(quantity);
+    }
+}
+
+void StockCounters::release(int product_id, int quantity) noexcept {
+    if(Counter* counter = find(product_id)) {
+        counter->available.fetch_add(quantity);
+    }
+}
+
+void StockCounters::restock(int product_id, int quantity) noexcept {
+    if(Counter* counter = find(product_id)) {
+        counter->on_hand.fetch_add(quantity);
+        counter->available.fetch_add(quantity);
+    }
+}
+
+int StockCounters::on_hand(int product_id) const noexcept {
+    const Counter* counter = find(product_id);
+    return counter ? counter->on_hand.load() : -1;
+}
+
+int StockCounters::available(int product_id) const noexcept {
+    const Counter* counter = find(product_id);
+    return counter ? counter->available.load() : -1;
+}
@@ -0,0 +1,148 @@
+#include "../../include/core/TrigramIndex.h"
+#include "../../include/core/Utf8.h"
+#include <algorithm>
+
+namespace {
+    // Разделитель полей не встречается во вводе и не даёт совпасть подстроке
+    // на стыке двух полей
+    constexpr char32_t field_separator = 0x1F;
+}
+
+void TrigramIndex::clear() {
+    postings_.clear();
+    folded_.clear();
+}
+
+void TrigramIndex::reserve(size_t count) {
+    folded_.reserve(count);
+}
+
+void TrigramIndex::grams_of(const std::u32string& text, size_t length, std::vector<Gram>& out) {
+    // Кодовая точка занимает 21 бит: триграмма - младшие 63 бита ключа,
+    // у символов и биграмм установлен старший бит, у символов ещё и бит 42
+    const Gram tag = length == 3 ? 0 : length == 2 ? Gram(1) << 63 : (Gram(1) << 63) | (Gram(1) << 42);
+    const size_t from = out.size();
+    for(size_t i = 0; i + length <= text.size(); ++i) {
+        Gram gram = tag;
+        bool separated = false;
+        for(size_t k = 0; k < length; ++k) {
+            separated = separated || text[i + k] == field_separator;
+            gram |= static_cast<Gram>(text[i + k]) << (21 * (length - 1 - k));
+        }
+        if(!separated) out.push_back(gram);
+    }
+    std::sort(out.begin() + from, out.end());
+    out.erase(std::unique(out.begin() + from, out.end()), out.end());
+}
+
+std::vector<TrigramIndex::Gram> TrigramIndex::document_grams(const std::u32string& text) {
+    std::vector<Gram> result;
+    result.reserve(text.size() * 3);
+    for(size_t length = 1; length <= 3; ++length) grams_of(text, length, result);
+    return result;
+}
+
+void TrigramIndex::insert_sorted(std::vector<int>& list, int id) {
+    // id растут монотонно, поэтому обычно это push_back
+    if(list.empty() || list.back() < id) {
+        list.push_back(id);
+        return;
+    }
+    auto it = std::lower_bound(list.begin(), list.end(), id);
+    if(it == list.end() || *it != id) list.insert(it, id);
+}
+
+void TrigramIndex::erase_sorted(std::vector<int>& list, int id) {
+    auto it = std::lower_bound(list.begin(), list.end(), id);
+    if(it != list.end() && *it == id) list.erase(it);
+}
+
+void TrigramIndex::add(int id, const std::vector<std::string_view>& fields) {
+    if(folded_.contains(id)) remove(id);
+
+    std::u32string text;
+    for(size_t i = 0; i < fields.size(); ++i) {
+        if(i > 0) text.push_back(field_separator);
+        text += Utf8::fold_decode(fields[i]);
+    }
+
+    for(Gram gram : document_grams(text)) {
+        insert_sorted(postings_[gram], id);
+    }
+
+    std::string stored;
+    stored.reserve(text.size());
+    for(char32_t c : text) Utf8::append(stored, c);
+    folded_.insert_or_assign(id, std::move(stored));
+}
+
+void TrigramIndex::remove(int id) {
+    const std::string* stored = folded_.find(id);
+    if(!stored) return;
+
+    for(Gram gram : document_grams(Utf8::decode(*stored))) {
+        auto it = postings_.find(gram);
+        if(it == postings_.end()) continue;
+        erase_sorted(it->second, id);
+        if(it->second.empty()) postings_.erase(it);
+    }
+    folded_.erase(id);
+}
+
+std::vector<int> TrigramIndex::search(std::string_view query) const {
+    const std::u32string folded_query = Utf8::fold_decode(query);
+    std::string needle;
+    for(char32_t c : folded_query) Utf8::append(needle, c);
+
+    std::vector<int> result;
+    if(folded_query.empty()) {
+        result = folded_.ids();
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::vector<Gram> grams;
+    grams_of(folded_query, std::min<size_t>(folded_query.size(), 3), grams);
+    if(grams.empty()) return result;
+
+    std::vector<const std::vector<int>*> lists;
+    lists.reserve(grams.size());
+    for(Gram gram : grams) {
+        auto it = postings_.find(gram);
+        if(it == postings_.end()) return result;
+        lists.push_back(&it->second);
+    }
+    // Символ или биграмма запроса совпадает с ним целиком
+    if(folded_query.size() < 3) return *lists.front();
+
+    std::sort(lists.begin(), lists.end(),
+        [](const auto* a, const auto* b) { return a->size() < b->size(); });
+
+    // Пересечение от самого короткого списка: кандидаты быстро отсеиваются,
+    // а длинные списки проходятся галопом (бинарный поиск от текущей позиции)
+    std::vector<int> candidates = *lists.front();
+    for(size_t k = 1; k < lists.size() && !candidates.empty(); ++k) {
+        const auto& list = *lists[k];
+        auto from = list.begin();
+        size_t kept = 0;
+        for(int id : candidates) {
+            from = std::lower_bound(from, list.end(), id);
+            if(from == list.end()) break;
+            if(*from == id) candidates[kept++] = id;
+        }
+        candidates.resize(kept);
+    }
+
+    // Все триграммы на месте ещё не гарантируют подстроку целиком
+    for(int id : candidates) {
+        const std::string* stored = folded_.find(id);
+        if(stored && stored->find(needle) != std::string::npos) {
+            result.push_back(id);
+        }
+    }
+    return result;
+}
+
+size_t TrigramIndex::size() const noexcept {
+    return folded_.size();
+}
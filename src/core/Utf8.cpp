@@ -0,0 +1,83 @@
+#include "../../include/core/Utf8.h"
+
+std::u32string Utf8::decode(std::string_view text) {
+    std::u32string result;
+    result.reserve(text.size());
+
+    size_t i = 0;
+    while(i < text.size()) {
+        const auto lead = static_cast<unsigned char>(text[i]);
+        size_t length = 1;
+        char32_t code_point = lead;
+
+        if(lead >= 0xF0 && lead < 0xF8) { length = 4; code_point = lead & 0x07; }
+        else if(lead >= 0xE0) { length = lead < 0xF0 ? 3 : 1; code_point = lead & 0x0F; }
+        else if(lead >= 0xC0) { length = 2; code_point = lead & 0x1F; }
+
+        if(length == 1 || i + length > text.size()) {
+            // ASCII либо повреждённая последовательность - байт как есть
+            result.push_back(lead);
+            ++i;
+            continue;
+        }
+
+        bool valid = true;
+        for(size_t k = 1; k < length; ++k) {
+            const auto next = static_cast<unsigned char>(text[i + k]);
+            if((next & 0xC0) != 0x80) { valid = false; break; }
+            code_point = (code_point << 6) | (next & 0x3F);
+        }
+        if(!valid) {
+            result.push_back(lead);
+            ++i;
+            continue;
+        }
+        result.push_back(code_point);
+        i += length;
+    }
+    return result;
+}
+
+void Utf8::append(std::string& out, char32_t code_point) {
+    if(code_point < 0x80) {
+        out.push_back(static_cast<char>(code_point));
+    } else if(code_point < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if(code_point < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+char32_t Utf8::fold(char32_t c) noexcept {
+    if(c >= U'A' && c <= U'Z') return c + 0x20;
+    if(c < 0x80) return c;
+    // Latin-1: À..Þ, кроме знака умножения
+    if(c >= 0xC0 && c <= 0xDE && c != 0xD7) return c + 0x20;
+    // Кириллица: Ѐ..Џ -> ѐ..џ, А..Я -> а..я
+    if(c >= 0x400 && c <= 0x40F) return c + 0x50;
+    if(c >= 0x410 && c <= 0x42F) return c + 0x20;
+    return c;
+}
+
+std::u32string Utf8::fold_decode(std::string_view text) {
+    std::u32string result = decode(text);
+    for(auto& c : result) c = fold(c);
+    return result;
+}
+
+std::string Utf8::fold(std::string_view text) {
+    std::string result;
+    result.reserve(text.size());
+    for(char32_t c : decode(text)) {
+        append(result, fold(c));
+    }
+    return result;
+}
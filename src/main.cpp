@@ -2,13 +2,55 @@
 #include "../include/ui/UI.h"
 #include <stdexcept>
 #include <filesystem>  
+#include <fstream>
+#include <iostream>
+#include <string>
 
+namespace {
+
+// computer_club --import-clients <file.csv> | --import-products <file.csv>
+int run_import(ClubSystem& system, const std::string& mode, const std::string& path) {
+    std::ifstream csv(path, std::ios::binary);
+    if(!csv) {
+        std::cerr << "Не удалось открыть файл: " << path << "\n";
+        return 1;
+    }
 
-int main() {
-    ClubSystem system; 
     system.initialize("data/club.db");
+    const auto report = mode == "--import-clients"
+        ? system.import_clients(csv)
+        : system.import_products(csv);
+    system.shutdown();
+
+    for(const auto& error : report.errors) {
+        std::cout << "Строка " << error.line << ": " << error.message << "\n";
+    }
+    std::cout << "Импортировано " << report.imported << " из " << report.rows
+              << " строк за " << report.seconds << " с ("
+              << static_cast<long long>(report.rows_per_second()) << " строк/с)\n";
+    return report.errors.empty() ? 0 : 2;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    ClubSystem system; 
+
+    if(argc > 1) {
+        const std::string mode = argv[1];
+        if(argc != 3 || (mode != "--import-clients" && mode != "--import-products")) {
+            std::cerr << "Использование: " << argv[0]
+                      << " [--import-clients <file.csv> | --import-products <file.csv>]\n";
+            return 1;
+        }
+        return run_import(system, mode, argv[2]);
+    }
+
+    system.initialize("data/club.db", ClubSystem::LoadMode::Parallel);
+    DatabaseManager::instance().set_group_commit({true, 64, std::chrono::milliseconds(5)});
     
     UI ui(system);
     ui.start();
+    system.shutdown();
     return 0;
-}
\ No newline at end of file
+}
@@ -18,6 +18,14 @@ Client::Client(int id, std::string name, std::string contact, time_t registered)
     validate_contact(contact_);
 }
 
+Client::Client(Trusted, int id, std::string name, std::string contact, time_t registered)
+    : id_(id),
+      name_(std::move(name)),
+      contact_(std::move(contact)),
+      registration_date_(registered)
+{
+}
+
 void Client::update_contact(const std::string& new_contact) {
     validate_contact(new_contact);
     contact_ = new_contact;
@@ -53,16 +61,57 @@ bool Client::has_active_bookings() const noexcept {
     return !reservation_ids_.empty();
 }
 
+namespace {
+
+bool is_ascii_digit(char c) noexcept {
+    return c >= '0' && c <= '9';
+}
+
+bool is_ascii_letter(char c) noexcept {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+bool is_local_char(char c) noexcept {
+    return is_ascii_letter(c) || is_ascii_digit(c) ||
+           c == '.' || c == '_' || c == '%' || c == '+' || c == '-';
+}
+
+bool is_domain_char(char c) noexcept {
+    return is_ascii_letter(c) || is_ascii_digit(c) || c == '.' || c == '-';
+}
+
+}
+
+bool Client::is_phone(std::string_view contact) noexcept {
+    if(contact.size() != 12 || contact[0] != '+' || contact[1] != '7') return false;
+    return std::all_of(contact.begin() + 2, contact.end(), is_ascii_digit);
+}
+
+bool Client::is_email(std::string_view contact) noexcept {
+    // '@' не входит ни в один из классов символов, поэтому он ровно один
+    const size_t at = contact.find('@');
+    if(at == std::string_view::npos || at == 0) return false;
+
+    const std::string_view local = contact.substr(0, at);
+    const std::string_view domain = contact.substr(at + 1);
+    if(!std::all_of(local.begin(), local.end(), is_local_char)) return false;
+    if(!std::all_of(domain.begin(), domain.end(), is_domain_char)) return false;
+
+    // Зона из одних букв не содержит точек, значит отделяющая её точка -
+    // последняя; перед ней нужен хотя бы один символ домена
+    const size_t dot = domain.rfind('.');
+    if(dot == std::string_view::npos || dot == 0) return false;
+
+    const std::string_view zone = domain.substr(dot + 1);
+    return zone.size() >= 2 && std::all_of(zone.begin(), zone.end(), is_ascii_letter);
+}
+
 void Client::validate_contact(const std::string& contact) const {
-    static const std::regex phone_regex(R"(^\+7\d{10}$)");
-    static const std::regex email_regex(R"(^[a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,}$)");
-    
     if(contact.empty()) {
         throw std::invalid_argument("Контакт не может быть пустым");
     }
     
-    if(!std::regex_match(contact, phone_regex) && 
-       !std::regex_match(contact, email_regex)) {
+    if(!is_phone(contact) && !is_email(contact)) {
         throw std::invalid_argument(
             "Неверный формат контакта. Используйте:\n"
             "- Телефон: +7XXXXXXXXXX (11 цифр)\n"
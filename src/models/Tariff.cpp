@@ -86,6 +86,14 @@ Tariff::Period Tariff::period() const noexcept {
     return period_; 
 }
 
+double Tariff::base_rate() const noexcept {
+    return base_rate_;
+}
+
+const std::vector<Tariff::Discount>& Tariff::discounts() const noexcept {
+    return discounts_;
+}
+
 void Tariff::set_period(Period new_period) { 
     period_ = new_period; 
 }
\ No newline at end of file
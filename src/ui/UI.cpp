@@ -18,16 +18,18 @@ void UI::mainMenu() {
               << "4. Управление клиентами\n"
               << "5. Управление продажами\n"
               << "6. Управление местами\n"
-              << "7. Выход\n";
+              << "7. Отчёты\n"
+              << "8. Выход\n";
     
-    switch(getChoice(1, 7)) {
+    switch(getChoice(1, 8)) {
         case 1: showSeats(); break;
         case 2: handleNewReservation(); break;
         case 3: showReservations(); break;
         case 4: clientManagementMenu(); break;
         case 5: salesMenu(); break;
         case 6: seatManagementMenu(); break;
-        case 7: running = false; break;
+        case 7: showReports(); break;
+        case 8: running = false; break;
     }
 }
 
@@ -35,15 +37,15 @@ void UI::showSeats() {
     clearScreen();
     printHeader("Карта мест компьютерного клуба");
     
-    const auto& seats = clubSystem.seats();
-    if(seats.empty()) {
+    const auto snapshot = clubSystem.seats();
+    if(snapshot->empty()) {
         std::cout << "Нет доступных мест!\n";
         waitForContinue();
         return;
     }
 
-    for(size_t i = 0; i < seats.size(); ++i) {
-        const auto& seat = seats[i];
+    size_t i = 0;
+    for(const auto& seat : *snapshot) {
         std::string color;
         std::string status;
         
@@ -72,7 +74,7 @@ void UI::showSeats() {
                   << "║ " << std::setw(10) << status << "   ║\n"
                   << "╚════════════╝\033[0m  ";
         
-        if((i + 1) % 5 == 0) std::cout << "\n\n";
+        if(++i % 5 == 0) std::cout << "\n\n";
     }
     
     std::cout << "\n\nЛегенда:\n"
@@ -167,15 +169,70 @@ void UI::salesMenu() {
     printHeader("Управление продажами");
     std::cout << "1. Список продуктов\n"
               << "2. Добавить новый продукт\n"
-              << "3. Назад\n";
+              << "3. Продажа\n"
+              << "4. Выручка за сегодня\n"
+              << "5. Назад\n";
     
-    switch(getChoice(1, 3)) {
+    switch(getChoice(1, 5)) {
         case 1: showProducts(); break;
         case 2: addNewProduct(); break;
-        case 3: return;
+        case 3: sellProduct(); break;
+        case 4: showRevenue(); break;
+        case 5: return;
     }
 }
 
+void UI::sellProduct() {
+    clearScreen();
+    printHeader("Продажа");
+
+    std::cout << "ID продукта: ";
+    int product_id = getChoice(1, INT_MAX);
+    std::cout << "Количество: ";
+    int quantity = getChoice(1, INT_MAX);
+    std::cout << "ID клиента (0 - без клиента): ";
+    int client_id = getChoice(0, INT_MAX);
+
+    if(awaitResult(clubSystem.sell_product_async(product_id, quantity, client_id))) {
+        std::cout << "\033[32mПродано. Остаток: "
+                  << clubSystem.product_stock(product_id) << "\033[0m\n";
+    } else {
+        std::cout << "\033[31mПродажа невозможна: нет товара, клиента "
+                  << "или недостаточно остатка\033[0m\n";
+    }
+    waitForContinue();
+}
+
+void UI::showRevenue() {
+    clearScreen();
+    printHeader("Выручка за сегодня");
+
+    const auto& sales = clubSystem.sales();
+    const time_t now = std::time(nullptr);
+    std::tm day = *std::localtime(&now);
+    day.tm_hour = day.tm_min = day.tm_sec = 0;
+    day.tm_isdst = -1;
+    const time_t day_start = std::mktime(&day);
+
+    const auto today = sales.day_totals(now);
+    std::cout << "Продаж: " << today.sales
+              << ", единиц: " << today.quantity
+              << ", выручка: " << std::fixed << std::setprecision(2) << today.revenue << "\n\n";
+
+    std::cout << std::left << std::setw(8) << " Час " << std::setw(10) << " Продаж "
+              << " Выручка\n";
+    for(time_t hour = day_start; hour <= now; hour += 3600) {
+        const auto totals = sales.hour_totals(hour);
+        if(totals.sales == 0) continue;
+        std::cout << std::setw(8) << format_time(hour).substr(11)
+                  << std::setw(10) << totals.sales
+                  << totals.revenue << "\n";
+    }
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(6);
+    waitForContinue();
+}
+
 void UI::showProducts() {
     clearScreen();
     printHeader("Доступные продукты");
@@ -277,8 +334,9 @@ void UI::handleNewReservation() {
     printHeader("Новое бронирование");
     
     try {
-        std::cout << "Выберите место (1-" << clubSystem.seats().size() << "): ";
-        int seat_id = getChoice(1, clubSystem.seats().size());
+        const int seat_count = static_cast<int>(clubSystem.seats()->size());
+        std::cout << "Выберите место (1-" << seat_count << "): ";
+        int seat_id = getChoice(1, seat_count);
         
         std::cout << "Имя клиента: ";
         std::string name;
@@ -291,8 +349,8 @@ void UI::handleNewReservation() {
         Client client = clubSystem.create_client(name, contact);
         
         time_t now = time(nullptr);
-        Reservation reservation = clubSystem.reservations().create_reservation(
-            client.id(), seat_id, now, now + 3600); 
+        Reservation reservation = awaitResult(clubSystem.reservations().create_reservation_async(
+            client.id(), seat_id, now, now + 3600));
         
         std::cout << "\n\033[32mБронирование #" << reservation.id() << " создано!\033[0m\n";
     } catch(const std::exception& e) {
@@ -302,26 +360,59 @@ void UI::handleNewReservation() {
 }
 
 void UI::showReservations() {
-    clearScreen();
-    printHeader("Текущие бронирования");
-    
-    const auto reservations = clubSystem.reservations().find_reservations();
-    std::cout << std::left << std::setw(10) << " ID " << std::setw(15) << " Клиент "
-              << std::setw(10) << " Место " << std::setw(20) << " Начало"
-              << std::setw(20) << " Окончание " << std::setw(15) << " Статус\n";
-    
-    for(const auto& res : reservations) {
-        try {
-            Client client = clubSystem.get_client(res.client_id());
-            std::cout << std::setw(10) << res.id()
-                      << std::setw(15) << client.name().substr(0, 14)
-                      << std::setw(10) << res.seat_id()
-                      << std::setw(20) << format_time(res.start_time())
-                      << std::setw(20) << format_time(res.end_time())
-                      << std::setw(15) << status_to_string(res.status()) << "\n";
-        } catch(...) {}
+    constexpr size_t page_size = 20;
+
+    ReservationManager::Query query;
+    query.order = ReservationManager::Order::StartDesc;
+    query.limit = page_size;
+
+    // Курсоры начала просмотренных страниц для перехода назад
+    std::vector<std::pair<time_t, int>> cursors;
+    size_t page_number = 1;
+
+    while(true) {
+        clearScreen();
+        printHeader("Текущие бронирования (стр. " + std::to_string(page_number) + ")");
+
+        const auto page = clubSystem.reservations().query_reservations(query);
+        std::cout << std::left << std::setw(10) << " ID " << std::setw(15) << " Клиент "
+                  << std::setw(10) << " Место " << std::setw(20) << " Начало"
+                  << std::setw(20) << " Окончание " << std::setw(15) << " Статус\n";
+        
+        for(const auto& res : page.items) {
+            try {
+                Client client = clubSystem.get_client(res.client_id());
+                std::cout << std::setw(10) << res.id()
+                          << std::setw(15) << client.name().substr(0, 14)
+                          << std::setw(10) << res.seat_id()
+                          << std::setw(20) << format_time(res.start_time())
+                          << std::setw(20) << format_time(res.end_time())
+                          << std::setw(15) << status_to_string(res.status()) << "\n";
+            } catch(...) {}
+        }
+
+        std::cout << "\n";
+        if(page.has_more) std::cout << "[n] Следующая  ";
+        if(!cursors.empty()) std::cout << "[p] Предыдущая  ";
+        std::cout << "[Enter] Выход: ";
+
+        std::string command;
+        if(!std::getline(std::cin, command)) return;
+
+        if(command == "n" && page.has_more) {
+            cursors.emplace_back(query.after_start, query.after_id);
+            query.after_start = page.items.back().start_time();
+            query.after_id = page.items.back().id();
+            ++page_number;
+        } else if(command == "p" && !cursors.empty()) {
+            query.after_start = cursors.back().first;
+            query.after_id = cursors.back().second;
+            cursors.pop_back();
+            --page_number;
+        } else if(command.empty()) {
+            return;
+        }
     }
-    waitForContinue();
 }
 
 void UI::addNewClient() {
@@ -387,6 +478,12 @@ void UI::clientLookup() {
     std::getline(std::cin, query);
     
     auto clients = clubSystem.find_clients(query);
+    if(clients.empty()) {
+        clients = clubSystem.find_clients_fuzzy(query);
+        if(!clients.empty()) {
+            std::cout << "Точных совпадений нет. Возможно, вы искали:\n";
+        }
+    }
     
     if(clients.empty()) {
         std::cout << "Клиенты не найдены\n";
@@ -481,10 +578,70 @@ void UI::changeSeatStatus() {
     }
     
     try {
-        clubSystem.update_seat_status(seat_id, new_status);
+        awaitResult(clubSystem.update_seat_status_async(seat_id, new_status));
         std::cout << "\033[32mСтатус успешно изменен!\033[0m\n";
     } catch(const std::exception& e) {
         std::cout << "\033[31mОшибка: " << e.what() << "\033[0m\n";
     }
     waitForContinue();
-}
\ No newline at end of file
+}
+
+void UI::showReports() {
+    clearScreen();
+    printHeader("Отчёты");
+
+    std::cout << "Период, дней (1-366): ";
+    const int days = getChoice(1, 366);
+    const time_t to = std::time(nullptr);
+    const time_t from = to - static_cast<time_t>(days) * 24 * 3600;
+
+    const auto columns = Analytics::load(clubSystem.reservations(), from, to);
+    const auto report = Analytics::build(columns, *clubSystem.seats(), from, to);
+
+    clearScreen();
+    printHeader("Отчёты за " + std::to_string(days) + " дн.");
+    std::cout << "Просмотрено броней: " << report.scanned << " за "
+              << std::fixed << std::setprecision(1) << report.seconds * 1000 << " мс\n\n";
+
+    std::cout << std::left << "Мест  Часов     Загрузка   Тип\n";
+    for(const auto& type : report.by_type) {
+        if(type.seats == 0) continue;
+        std::cout << std::setw(6) << type.seats
+                  << std::setw(10) << type.occupied_hours
+                  << std::right << std::setw(7) << type.utilization * 100 << "%   " << std::left
+                  << seatTypeToString(type.type) << "\n";
+    }
+
+    // Средняя по местам загрузка: строка - день недели, столбец - час
+    static const char* const weekdays[] = {"Пн", "Вт", "Ср", "Чт", "Пт", "Сб", "Вс"};
+    static const char shades[] = " .:-=+*#%@";
+    const size_t seat_count = report.heatmap.seat_ids.size();
+    std::cout << "\nЗагрузка по часам недели (' ' - 0%, '@' - 100%)\n   ";
+    for(int hour = 0; hour < 24; ++hour) std::cout << (hour % 6 == 0 ? '|' : ' ');
+    std::cout << "\n";
+    for(int day = 0; day < 7; ++day) {
+        std::cout << weekdays[day] << " ";
+        for(int hour = 0; hour < 24; ++hour) {
+            double sum = 0.0;
+            for(size_t seat = 0; seat < seat_count; ++seat) {
+                sum += report.heatmap.at(seat, day * 24 + hour);
+            }
+            const double occupancy = seat_count ? std::min(1.0, sum / seat_count) : 0.0;
+            std::cout << shades[static_cast<int>(occupancy * 9 + 0.5)];
+        }
+        std::cout << "\n";
+    }
+
+    double revenue = 0.0;
+    for(const auto& day : report.revenue) revenue += day.revenue;
+    std::cout << "\nВыручка за период: " << std::setprecision(2) << revenue << "\n";
+    const size_t shown = std::min<size_t>(report.revenue.size(), 14);
+    for(size_t i = report.revenue.size() - shown; i < report.revenue.size(); ++i) {
+        const auto& day = report.revenue[i];
+        std::cout << format_time(day.day).substr(0, 10) << "  "
+                  << std::setw(6) << day.reservations << day.revenue << "\n";
+    }
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(6);
+    waitForContinue();
+}
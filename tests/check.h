@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+// Минимальные проверки для тестов: сбой печатается, тест продолжается,
+// код возврата main - число сбоев
+namespace check {
+
+inline int failures = 0;
+
+inline int result() {
+    if(failures) std::cerr << failures << " check(s) failed\n";
+    return failures ? 1 : 0;
+}
+
+// Путь к файлу БД, уникальный для процесса; старые файлы удаляются
+inline std::string temp_db(const std::string& name) {
+    const auto dir = std::filesystem::temp_directory_path() /
+                     ("club_test_" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir);
+    const auto path = dir / (name + ".db");
+    for(const char* suffix : {"", "-wal", "-shm", ".snap"}) {
+        std::filesystem::remove(path.string() + suffix);
+    }
+    return path.string();
+}
+
+}
+
+#define CHECK(cond) \
+    do { \
+        if(!(cond)) { \
+            ++check::failures; \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed\n"; \
+        } \
+    } while(0)
+
+#define CHECK_EQ(a, b) \
+    do { \
+        const auto check_a_ = (a); \
+        const auto check_b_ = (b); \
+        if(!(check_a_ == check_b_)) { \
+            ++check::failures; \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK_EQ(" #a ", " #b ") failed: " \
+                      << check_a_ << " != " << check_b_ << "\n"; \
+        } \
+    } while(0)
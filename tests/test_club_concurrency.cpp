@@ -0,0 +1,120 @@
+// Одновременные чтения и изменения ClubSystem: читатели видят целые версии
+// снимков, после остановки память совпадает с БД
+#include "check.h"
+#include "../include/core/ClubSystem.h"
+#include "../include/core/DatabaseManager.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int preloaded = 2000;
+constexpr int writers = 2;
+constexpr int writes_per_thread = 150;
+constexpr int readers = 3;
+constexpr int stock = 500;
+
+std::string phone(int n) {
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "+7%010d", n);
+    return buffer;
+}
+
+}
+
+int main() {
+    const std::string path = check::temp_db("club_concurrency");
+    {
+        ClubSystem system;
+        system.initialize(path);
+        std::stringstream csv;
+        csv << "name,contact\n";
+        for(int i = 0; i < preloaded; ++i) csv << "Клиент " << i << "," << phone(i) << "\n";
+        CHECK_EQ(system.import_clients(csv).imported, size_t(preloaded));
+        system.add_product(Product(0, "Cola", Product::Category::Drink, 1.5, stock));
+        system.shutdown();
+    }
+    // Без снимка клиенты догружаются в фоне, пока работают потоки ниже
+    std::remove((path + ".snap").c_str());
+
+    ClubSystem system;
+    system.initialize(path, ClubSystem::LoadMode::Parallel);
+    DatabaseManager::instance().set_group_commit({true, 64, std::chrono::milliseconds(2)});
+    const int product_id = system.get_products().at(0).id();
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> sold{0};
+    std::atomic<long> read_errors{0};
+    std::vector<std::thread> threads;
+
+    for(int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            size_t last_size = 0;
+            while(!stop) {
+                // Версия снимка не меняется под читателем, а новые версии
+                // только добавляют клиентов
+                const auto clients = system.clients();
+                size_t count = 0;
+                for(const auto& client : *clients) {
+                    if(clients->find(client.id()) != &client) ++read_errors;
+                    ++count;
+                }
+                if(count != clients->size() || count < last_size) ++read_errors;
+                last_size = count;
+
+                if(system.find_clients(phone(r * 7)).empty()) ++read_errors;
+                if(system.seats()->size() != 60) ++read_errors;
+                if(system.sell_product(product_id, 1)) ++sold;
+            }
+        });
+    }
+
+    std::vector<std::map<int, std::string>> expected(writers);
+    for(int w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w] {
+            for(int i = 0; i < writes_per_thread; ++i) {
+                const int n = preloaded + w * writes_per_thread + i;
+                const Client client = system.create_client("Новый " + std::to_string(n), phone(n));
+                expected[w][client.id()] = client.contact();
+                if(i % 3 == 0) {
+                    const std::string email = "c" + std::to_string(n) + "@club.ru";
+                    if(system.update_client(client.id(), email)) expected[w][client.id()] = email;
+                }
+                // Занятый контакт отклоняется, клиент не меняется
+                if(i % 5 == 0) CHECK(!system.update_client(client.id(), phone(0)));
+                system.update_seat_status(1 + (n % 60), i % 2 ? Seat::Status::Free : Seat::Status::Occupied);
+            }
+        });
+    }
+
+    for(int w = 0; w < writers; ++w) threads[readers + w].join();
+    stop = true;
+    for(int r = 0; r < readers; ++r) threads[r].join();
+
+    CHECK_EQ(read_errors.load(), 0L);
+    CHECK(sold <= stock);
+    CHECK_EQ(system.product_stock(product_id), stock - sold.load());
+
+    const auto clients = system.clients();
+    CHECK_EQ(clients->size(), size_t(preloaded + writers * writes_per_thread));
+    for(const auto& written : expected) {
+        for(const auto& [id, contact] : written) CHECK_EQ(clients->at(id).contact(), contact);
+    }
+    system.shutdown();
+
+    // Память после остановки совпадает с БД
+    DatabaseManager::instance().connect(path);
+    const auto rows = DatabaseManager::instance().fetch_all("SELECT id, contact FROM clients");
+    CHECK_EQ(rows.size(), clients->size());
+    for(const auto& row : rows) CHECK_EQ(row.get_text(1), clients->at(row.get_int(0)).contact());
+    const auto products = DatabaseManager::instance().fetch_all(
+        "SELECT stock FROM products WHERE id = ?", {product_id});
+    CHECK_EQ(products.at(0).get_int(0), stock - sold.load());
+    DatabaseManager::instance().disconnect();
+    return check::result();
+}
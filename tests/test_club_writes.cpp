@@ -0,0 +1,73 @@
+// Изменения через ClubSystem при групповой фиксации: ошибка записи
+// возвращается вызывающему, и память остаётся согласованной с БД
+#include "check.h"
+#include "../include/core/ClubSystem.h"
+#include "../include/core/DatabaseManager.h"
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main() {
+    const std::string path = check::temp_db("club_writes");
+    std::string final_contact;
+    {
+        ClubSystem system;
+        system.initialize(path);
+        DatabaseManager::instance().set_group_commit({true, 64, std::chrono::milliseconds(5)});
+
+        const Client first = system.create_client("Иван Петров", "+79990000001");
+        const Client second = system.create_client("Пётр Иванов", "+79990000002");
+
+        // Контакт уникален: UPDATE падает при фиксации порции
+        CHECK(!system.update_client(first.id(), second.contact()));
+        CHECK_EQ(system.get_client(first.id()).contact(), first.contact());
+
+        CHECK(system.update_client(first.id(), "ivan@mail.ru"));
+        CHECK_EQ(system.get_client(first.id()).contact(), std::string("ivan@mail.ru"));
+
+        const int seat_id = system.seats()->begin()->id();
+        system.update_seat_status(seat_id, Seat::Status::Maintenance);
+        CHECK(system.get_seat(seat_id).status() == Seat::Status::Maintenance);
+
+        // Билет ждётся без write_mutex_: одновременные изменения уходят одной
+        // порцией, а не ждут max_delay друг за другом. Память совпадает с БД,
+        // в каком бы порядке ни завершились билеты.
+        auto& db = DatabaseManager::instance();
+        db.set_group_commit({true, 64, std::chrono::milliseconds(50)});
+        constexpr int writers = 8;
+        constexpr int rounds = 10;
+        const auto started = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for(int t = 0; t < writers; ++t) {
+            threads.emplace_back([&system, &first, seat_id, t] {
+                for(int i = 0; i < rounds; ++i) {
+                    const std::string contact = "ivan" + std::to_string(t * rounds + i) + "@mail.ru";
+                    CHECK(system.update_client(first.id(), contact));
+                    system.update_seat_status(seat_id, (t + i) % 2 ? Seat::Status::Free
+                                                                   : Seat::Status::Maintenance);
+                }
+            });
+        }
+        for(auto& thread : threads) thread.join();
+        // Ожидание под write_mutex_ заняло бы не меньше writers * rounds * 2 * 50 мс = 8 с
+        CHECK(std::chrono::steady_clock::now() - started < std::chrono::seconds(4));
+        final_contact = std::string(
+            db.fetch_all("SELECT contact FROM clients WHERE id = ?", {first.id()}).at(0).get_text(0));
+        CHECK_EQ(system.get_client(first.id()).contact(), final_contact);
+        const int seat_status = db.fetch_all("SELECT status FROM seats WHERE id = ?", {seat_id}).at(0).get_int(0);
+        CHECK_EQ(static_cast<int>(system.get_seat(seat_id).status()), seat_status);
+
+        system.shutdown();
+    }
+
+    ClubSystem reopened;
+    reopened.initialize(path);
+    const auto clients = reopened.clients();
+    CHECK_EQ(clients->size(), size_t(2));
+    for(const auto& client : *clients) {
+        CHECK(client.contact() == final_contact || client.contact() == "+79990000002");
+    }
+    reopened.shutdown();
+    return check::result();
+}
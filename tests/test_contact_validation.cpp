@@ -0,0 +1,76 @@
+// Дифференциальная проверка Client::is_phone / is_email против регулярных
+// выражений, которыми контакт проверялся раньше
+#include "check.h"
+#include "../include/models/Client.h"
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace {
+
+const std::regex phone_regex(R"(^\+7\d{10}$)");
+const std::regex email_regex(R"(^[a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,}$)");
+
+long mismatches = 0;
+
+void compare(const std::string& contact) {
+    const bool phone = Client::is_phone(contact);
+    const bool email = Client::is_email(contact);
+    const bool old_phone = std::regex_match(contact, phone_regex);
+    const bool old_email = std::regex_match(contact, email_regex);
+    if(phone != old_phone || email != old_email) {
+        if(mismatches++ < 10) {
+            std::cerr << "mismatch for [" << contact << "]: phone " << phone << "/" << old_phone
+                      << ", email " << email << "/" << old_email << "\n";
+        }
+    }
+}
+
+}
+
+int main() {
+    const std::vector<std::string> edge_cases = {
+        "", "+", "+7", "+71234567890", "+7123456789", "+712345678901", "71234567890",
+        "+81234567890", "+7123456789a", " +71234567890", "+71234567890\n", "+7１２３",
+        "a@b.cc", "a@b.c", "@b.cc", "a@.cc", "a@b.", "a@b.c1", "a@@b.cc", "a@b..cc",
+        "a.b@c.d.ef", "a%b+c-d_e@x-y.zz", "a@b.cc.", "a@b.cc ", "A@B.CC", "a b@c.dd",
+        "a@b_c.dd", "a@b.CCcc", "ab.c@mail.ru", "ab.c@mail.r", "ab.c@mail.ru@x.yy",
+        "a@b.c\xd0\xb9", "\xd0\xb9@b.cc", "a@b.-c", "a@-.cc", ".@..cc", "+7@b.cc"
+    };
+    for(const auto& contact : edge_cases) compare(contact);
+
+    // Случайные строки из символов, значимых для обоих форматов, и мутации
+    // допустимых контактов: замена, вставка и удаление символа
+    const std::string alphabet = "+7a0Z9.@_%-bc \xd0\x01";
+    std::mt19937 random(2024);
+    const auto pick = [&] { return alphabet[random() % alphabet.size()]; };
+
+    for(int i = 0; i < 200000; ++i) {
+        std::string contact;
+        switch(random() % 4) {
+            case 0:
+                contact = "+7";
+                for(int k = 0; k < 10; ++k) contact += static_cast<char>('0' + random() % 10);
+                break;
+            case 1:
+                contact = "ab.c@mail.ru";
+                break;
+            default:
+                for(int k = 0, n = static_cast<int>(random() % 16); k < n; ++k) contact += pick();
+                break;
+        }
+        for(int edits = static_cast<int>(random() % 3); edits > 0 && !contact.empty(); --edits) {
+            const size_t at = random() % contact.size();
+            switch(random() % 3) {
+                case 0: contact[at] = pick(); break;
+                case 1: contact.insert(contact.begin() + at, pick()); break;
+                case 2: contact.erase(at, 1); break;
+            }
+        }
+        compare(contact);
+    }
+
+    CHECK_EQ(mismatches, 0L);
+    return check::result();
+}
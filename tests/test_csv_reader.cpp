@@ -0,0 +1,52 @@
+// Разбор CSV: BOM, кавычки, окончания строк и повреждённые записи
+#include "check.h"
+#include "../include/core/CsvReader.h"
+#include <sstream>
+
+namespace {
+
+std::vector<CsvReader::Record> parse(const std::string& text) {
+    std::istringstream in(text);
+    CsvReader reader(in);
+    std::vector<CsvReader::Record> records;
+    while(reader.read_chunk(2, records)) {}
+    return records;
+}
+
+}
+
+int main() {
+    {
+        const auto records = parse("\xEF\xBB\xBFname,contact\r\nA,\"x,\"\"y\"\"\"\n\n\"multi\nline\",z\n");
+        CHECK_EQ(records.size(), size_t(3));
+        CHECK_EQ(records[0].fields[0], std::string("name"));
+        CHECK_EQ(records[1].fields[1], std::string("x,\"y\""));
+        CHECK_EQ(records[2].line, size_t(4));
+        CHECK_EQ(records[2].fields[0], std::string("multi\nline"));
+        for(const auto& record : records) CHECK(record.error.empty());
+    }
+
+    // Неполный BOM - обычные данные, прочитанные байты не теряются
+    {
+        const auto records = parse("\xEF\xBBx,y\n\xEF,z");
+        CHECK_EQ(records.size(), size_t(2));
+        CHECK_EQ(records[0].fields[0], std::string("\xEF\xBBx"));
+        CHECK_EQ(records[1].fields[0], std::string("\xEF"));
+        CHECK_EQ(records[1].fields[1], std::string("z"));
+    }
+    {
+        const auto records = parse("\xEF");
+        CHECK_EQ(records.size(), size_t(1));
+        CHECK_EQ(records[0].fields[0], std::string("\xEF"));
+    }
+
+    // Незакрытая кавычка в конце файла - повреждённая запись
+    {
+        const auto records = parse("a,b\nc,\"d\ne");
+        CHECK_EQ(records.size(), size_t(2));
+        CHECK(records[0].error.empty());
+        CHECK_EQ(records[1].line, size_t(2));
+        CHECK(!records[1].error.empty());
+    }
+    return check::result();
+}
@@ -0,0 +1,113 @@
+// Ограниченное расстояние Левенштейна против полной таблицы и поиск
+// FuzzyNameIndex против перебора всех имён
+#include "check.h"
+#include "../include/core/FuzzyNameIndex.h"
+#include "../include/core/Utf8.h"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+
+int reference(const std::u32string& a, const std::u32string& b) {
+    std::vector<std::vector<int>> table(a.size() + 1, std::vector<int>(b.size() + 1));
+    for(size_t i = 0; i <= a.size(); ++i) table[i][0] = static_cast<int>(i);
+    for(size_t j = 0; j <= b.size(); ++j) table[0][j] = static_cast<int>(j);
+    for(size_t i = 1; i <= a.size(); ++i) {
+        for(size_t j = 1; j <= b.size(); ++j) {
+            table[i][j] = std::min({table[i - 1][j] + 1, table[i][j - 1] + 1,
+                                    table[i - 1][j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1)});
+        }
+    }
+    return table[a.size()][b.size()];
+}
+
+std::string encode(const std::u32string& text) {
+    std::string result;
+    for(char32_t c : text) Utf8::append(result, c);
+    return result;
+}
+
+}
+
+int main() {
+    std::mt19937 random(5);
+    const std::u32string alphabet = U"абвгaeb";
+    const auto word = [&](size_t max_length) {
+        std::u32string result;
+        for(size_t n = random() % (max_length + 1); n > 0; --n) {
+            result.push_back(alphabet[random() % alphabet.size()]);
+        }
+        return result;
+    };
+
+    long mismatches = 0;
+    for(int i = 0; i < 100000; ++i) {
+        const auto a = word(12);
+        const auto b = word(12);
+        const int expected = reference(a, b);
+        const int bound = static_cast<int>(random() % 6);
+        if(FuzzyNameIndex::distance(a, b, bound) != std::min(expected, bound + 1)) ++mismatches;
+        if(FuzzyNameIndex::distance(a, b) != expected) ++mismatches;
+    }
+    CHECK_EQ(mismatches, 0L);
+
+    // Имена из двух слов; клиент подходит, если каждое слово запроса ближе
+    // max_edits к какому-то слову имени, расстояние - сумма лучших
+    FuzzyNameIndex index;
+    std::map<int, std::vector<std::u32string>> names;
+    for(int id = 1; id <= 3000; ++id) {
+        const std::u32string first = U"И" + word(5);
+        const std::u32string last = U"п" + word(7);
+        names[id] = {Utf8::fold_decode(encode(first)), Utf8::fold_decode(encode(last))};
+        index.add(id, encode(first) + " " + encode(last));
+    }
+    // Запрос - фамилия с опечаткой, иногда вместе с именем
+    const auto check_queries = [&](int count) {
+        for(int q = 0; q < count; ++q) {
+            auto target = names.begin();
+            std::advance(target, random() % names.size());
+            std::u32string typo = target->second[1];
+            if(!typo.empty()) typo[random() % typo.size()] = alphabet[random() % alphabet.size()];
+            std::vector<std::u32string> query = {typo};
+            if(random() % 3 != 0) query.push_back(target->second[0]);
+            const int max_edits = 1 + static_cast<int>(random() % 2);
+
+            std::vector<FuzzyNameIndex::Match> expected;
+            for(const auto& [id, words] : names) {
+                int total = 0;
+                for(const auto& term : query) {
+                    int best = max_edits + 1;
+                    for(const auto& w : words) best = std::min(best, reference(term, w));
+                    total = best > max_edits || total < 0 ? -1 : total + best;
+                }
+                if(total >= 0) expected.push_back({id, total});
+            }
+            std::sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) {
+                return a.distance != b.distance ? a.distance < b.distance : a.id < b.id;
+            });
+
+            std::string text = encode(query[0]);
+            if(query.size() > 1) text += " " + encode(query[1]);
+            const auto found = index.search(text, max_edits, expected.size() + 1);
+            CHECK_EQ(found.size(), expected.size());
+            for(size_t i = 0; i < std::min(found.size(), expected.size()); ++i) {
+                CHECK_EQ(found[i].id, expected[i].id);
+                CHECK_EQ(found[i].distance, expected[i].distance);
+            }
+        }
+    };
+    check_queries(300);
+
+    // Удалённые клиенты не находятся, слова остальных клиентов на месте
+    for(int removed = 0; removed < 1000; ++removed) {
+        auto it = names.begin();
+        std::advance(it, random() % names.size());
+        index.remove(it->first, encode(it->second[0]) + " " + encode(it->second[1]));
+        names.erase(it);
+    }
+    check_queries(300);
+
+    return check::result();
+}
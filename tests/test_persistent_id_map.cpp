@@ -0,0 +1,85 @@
+// Версии PersistentIdMap: изменения копии не видны в исходной карте
+#include "check.h"
+#include "../include/core/PersistentIdMap.h"
+#include <climits>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Map = PersistentIdMap<std::string>;
+
+bool same(const Map& map, const std::map<int, std::string>& expected) {
+    if(map.size() != expected.size()) return false;
+    auto it = expected.begin();
+    for(const auto& value : map) {
+        if(it == expected.end() || value != it->second) return false;
+        if(map.find(it->first) != &value) return false;
+        ++it;
+    }
+    return it == expected.end();
+}
+
+}
+
+int main() {
+    Map empty;
+    CHECK(empty.empty());
+    CHECK(empty.begin() == empty.end());
+    CHECK(empty.find(0) == nullptr);
+    CHECK(empty.find(-1) == nullptr);
+
+    // Каждая версия сравнивается с std::map, сохранённым в момент копирования
+    std::mt19937 random(11);
+    std::vector<Map> versions;
+    std::vector<std::map<int, std::string>> expected;
+    Map map;
+    std::map<int, std::string> model;
+    for(int i = 0; i < 5000; ++i) {
+        const int id = (i % 7 == 0) ? static_cast<int>(random() % 300000) : static_cast<int>(random() % 2000);
+        const std::string value = std::to_string(i);
+        map.insert_or_assign(id, value);
+        model[id] = value;
+        if(i % 500 == 0) {
+            versions.push_back(map);
+            expected.push_back(model);
+        }
+    }
+    CHECK(same(map, model));
+    for(size_t v = 0; v < versions.size(); ++v) CHECK(same(versions[v], expected[v]));
+
+    // Рост дерева до крайних id не теряет старые значения
+    Map wide;
+    wide.insert_or_assign(5, std::string("five"));
+    const Map before = wide;
+    wide.insert_or_assign(INT_MAX, std::string("max"));
+    CHECK_EQ(wide.at(5), std::string("five"));
+    CHECK_EQ(wide.at(INT_MAX), std::string("max"));
+    CHECK_EQ(wide.size(), size_t(2));
+    CHECK(!before.contains(INT_MAX));
+    CHECK_EQ(before.size(), size_t(1));
+
+    // Builder на основе версии не меняет её узлы
+    Map::Builder builder(map);
+    std::map<int, std::string> built = model;
+    for(int id = 0; id < 3000; ++id) {
+        builder.insert_or_assign(id, std::string("b") + std::to_string(id));
+        built[id] = std::string("b") + std::to_string(id);
+    }
+    const Map result = builder.build();
+    CHECK(same(result, built));
+    CHECK(same(map, model));
+    CHECK(builder.size() == 0);
+
+    // Узлы выданной версии чужие для любого builder'а
+    Map::Builder again(result);
+    again.insert_or_assign(1, std::string("again"));
+    CHECK_EQ(again.build().at(1), std::string("again"));
+    CHECK_EQ(result.at(1), std::string("b1"));
+
+    const auto held = result.get(2);
+    CHECK(held && *held == "b2");
+    return check::result();
+}
@@ -0,0 +1,115 @@
+// Пакетный расчёт цен: векторное ядро, скалярный путь и price() совпадают
+// побитово на любых длинах пакета, включая хвосты не кратные четырём
+#include "check.h"
+#include "../include/core/PricingEngine.h"
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+constexpr time_t day = 86400;
+constexpr time_t base = 1791763200 - 30 * day;
+constexpr time_t horizon = 90 * day;
+
+PricingEngine make_engine() {
+    PricingEngine engine;
+    int id = 1;
+    for(int type = 0; type < static_cast<int>(PricingEngine::seat_type_count); ++type) {
+        Tariff peak(id++, "Пик", 120 + type * 37.3, Tariff::Period::Peak);
+        peak.add_discount(13.7, base + type * 5000, base + type * 5000 + 3 * day);
+        engine.set_tariff(static_cast<Seat::Type>(type), peak);
+        engine.set_tariff(static_cast<Seat::Type>(type), Tariff(id++, "День", 77.7 + type, Tariff::Period::OffPeak));
+        engine.set_tariff(static_cast<Seat::Type>(type), Tariff(id++, "Праздник", 333.3, Tariff::Period::Holiday));
+    }
+    engine.add_holiday(base + 10 * day, base + 11 * day);
+    engine.compile(base, base + horizon);
+    return engine;
+}
+
+bool same_bits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+}
+
+int main() {
+    const PricingEngine engine = make_engine();
+    std::mt19937_64 random(21);
+
+    // Случайные интервалы, а также начала и концы ровно на точках смены
+    // ставки и на краях горизонта
+    const auto& points = engine.breakpoints();
+    const auto random_batch = [&](size_t count) {
+        PricingEngine::BatchColumns batch;
+        for(size_t i = 0; i < count; ++i) {
+            time_t start;
+            time_t end;
+            switch(random() % 4) {
+                case 0:
+                    start = points[random() % (points.size() - 1)];
+                    end = std::min(base + horizon, start + 1 + static_cast<time_t>(random() % day));
+                    break;
+                case 1:
+                    end = points[1 + random() % (points.size() - 1)];
+                    start = std::max(base, end - 1 - static_cast<time_t>(random() % day));
+                    break;
+                case 2:
+                    start = base;
+                    end = base + horizon;
+                    break;
+                default:
+                    start = base + static_cast<time_t>(random() % (horizon - day));
+                    end = start + 1 + static_cast<time_t>(random() % day);
+                    break;
+            }
+            batch.start.push_back(start);
+            batch.end.push_back(end);
+            batch.seat_type.push_back(static_cast<int32_t>(random() % PricingEngine::seat_type_count));
+        }
+        return batch;
+    };
+
+    long mismatches = 0;
+    std::vector<size_t> sizes;
+    for(size_t n = 0; n <= 19; ++n) sizes.push_back(n);
+    for(size_t n : {63, 64, 65, 1021, 4099}) sizes.push_back(n);
+    for(int round = 0; round < 20; ++round) {
+        for(size_t n : sizes) {
+            const auto batch = random_batch(n);
+            const auto prices = engine.price_batch(batch);
+            std::vector<double> scalar(n);
+            engine.price_batch_scalar(batch, scalar.data());
+            CHECK_EQ(prices.size(), n);
+            for(size_t i = 0; i < n; ++i) {
+                const double single = engine.price(static_cast<Seat::Type>(batch.seat_type[i]),
+                                                   batch.start[i], batch.end[i]);
+                if(!same_bits(prices[i], scalar[i]) || !same_bits(prices[i], single)) ++mismatches;
+            }
+        }
+    }
+    CHECK_EQ(mismatches, 0L);
+
+    // Ошибка в любой строке пакета, в том числе в хвосте, отклоняет пакет
+    auto bad = random_batch(7);
+    bad.end[6] = base + horizon + 1;
+    bool out_of_range = false;
+    try {
+        engine.price_batch(bad);
+    } catch(const std::out_of_range&) {
+        out_of_range = true;
+    }
+    CHECK(out_of_range);
+    bad = random_batch(5);
+    bad.seat_type[4] = static_cast<int32_t>(PricingEngine::seat_type_count);
+    bool invalid = false;
+    try {
+        engine.price_batch(bad);
+    } catch(const std::invalid_argument&) {
+        invalid = true;
+    }
+    CHECK(invalid);
+
+    std::cout << "simd kernel: " << (PricingEngine::simd_available() ? "avx2" : "scalar only") << "\n";
+    return check::result();
+}
@@ -0,0 +1,98 @@
+// Цены PricingEngine на границах ставок, горизонта и при округлении
+#include "check.h"
+#include "../include/core/PricingEngine.h"
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+constexpr time_t hour = 3600;
+constexpr time_t day = 24 * hour;
+constexpr time_t monday = 1791763200;      // 2026-10-12 00:00 UTC
+
+template<typename Exception, typename Fn>
+bool throws(Fn&& fn) {
+    try {
+        fn();
+    } catch(const Exception&) {
+        return true;
+    } catch(...) {
+    }
+    return false;
+}
+
+}
+
+int main() {
+    // Расписание по умолчанию считается по местному времени
+    setenv("TZ", "UTC", 1);
+    tzset();
+
+    PricingEngine engine;
+    engine.set_tariff(Seat::Type::Standard, Tariff(1, "Пик", 120, Tariff::Period::Peak));
+    engine.set_tariff(Seat::Type::Standard, Tariff(2, "День", 60, Tariff::Period::OffPeak));
+    engine.set_tariff(Seat::Type::Standard, Tariff(3, "Праздник", 240, Tariff::Period::Holiday));
+    Tariff vip(4, "VIP", 100, Tariff::Period::Peak);
+    vip.add_discount(50, monday + day + 19 * hour, monday + day + 20 * hour);
+    engine.set_tariff(Seat::Type::VIP, vip);
+    engine.add_holiday(monday + 2 * day, monday + 3 * day);
+    engine.compile(monday, monday + 7 * day);
+
+    const auto standard = [&](time_t start, time_t end) {
+        return engine.price(Seat::Type::Standard, start, end);
+    };
+
+    // Бронь через смену ставки: 30 минут дневного тарифа и 30 минут пика
+    CHECK_EQ(standard(monday + 17 * hour + 1800, monday + 18 * hour + 1800), 90.0);
+    // Начало и конец ровно на границе - без захвата соседнего отрезка
+    CHECK_EQ(standard(monday + 18 * hour, monday + 19 * hour), 120.0);
+    CHECK_EQ(standard(monday + 17 * hour, monday + 18 * hour), 60.0);
+    CHECK_EQ(standard(monday + 17 * hour, monday + 18 * hour + 1), 60.03);
+    // Через полночь в праздник: час пика и час праздничного тарифа
+    CHECK_EQ(standard(monday + day + 23 * hour, monday + 2 * day + hour), 360.0);
+    CHECK_EQ(standard(monday + 3 * day - hour, monday + 3 * day), 240.0);
+    CHECK_EQ(standard(monday + 3 * day, monday + 3 * day + hour), 60.0);
+    // Скидка внутри брони: 30 минут по 100, час по 50, 30 минут по 100
+    CHECK_EQ(engine.price(Seat::Type::VIP, monday + day + 18 * hour + 1800,
+                          monday + day + 20 * hour + 1800), 150.0);
+    // Типа без тарифов нет в шкале - бесплатно
+    CHECK_EQ(engine.price(Seat::Type::Gaming, monday, monday + hour), 0.0);
+
+    // Горизонт [from, to): обе границы допустимы, выход на секунду - ошибка
+    CHECK_EQ(standard(monday + 7 * day - hour, monday + 7 * day), 120.0);
+    CHECK_EQ(standard(monday, monday + hour), 60.0);
+    CHECK(engine.covers(monday, monday + 7 * day));
+    CHECK(!engine.covers(monday, monday + 7 * day + 1));
+    CHECK(throws<std::out_of_range>([&] { standard(monday + 7 * day - hour, monday + 7 * day + 1); }));
+    CHECK(throws<std::out_of_range>([&] { standard(monday - 1, monday + hour); }));
+    CHECK(throws<std::invalid_argument>([&] { standard(monday + hour, monday + hour); }));
+
+    // Округление до копеек, половина - от нуля
+    CHECK_EQ(PricingEngine::round_price(0.125), 0.13);
+    CHECK_EQ(PricingEngine::round_price(0.375), 0.38);
+    CHECK_EQ(PricingEngine::round_price(-0.125), -0.13);
+    CHECK_EQ(PricingEngine::round_price(0.124), 0.12);
+    CHECK_EQ(PricingEngine::round_price(2.5), 2.5);
+    CHECK_EQ(PricingEngine::round_price(0.0), 0.0);
+    // 1 секунда по 45/час = 0.0125
+    PricingEngine cents;
+    cents.set_tariff(Seat::Type::Standard, Tariff(5, "Ровно", 45, Tariff::Period::Peak));
+    cents.compile(monday, monday + day);
+    CHECK_EQ(cents.price(Seat::Type::Standard, monday, monday + 1), 0.01);
+    CHECK_EQ(cents.price(Seat::Type::Standard, monday, monday + 2), 0.03);
+
+    // Разбиение брони в любой точке сохраняет сумму с точностью до
+    // округления трёх цен (по полкопейки)
+    std::mt19937 random(3);
+    for(int i = 0; i < 10000; ++i) {
+        const time_t start = monday + static_cast<time_t>(random() % (7 * day - 2));
+        const time_t end = start + 2 + static_cast<time_t>(random() % (monday + 7 * day - start - 1));
+        const time_t split = start + 1 + static_cast<time_t>(random() % (end - start - 1));
+        const double whole = standard(start, end);
+        const double parts = standard(start, split) + standard(split, end);
+        CHECK(std::fabs(whole - parts) <= 0.015 + 1e-9);
+    }
+    return check::result();
+}
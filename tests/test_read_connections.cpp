@@ -0,0 +1,49 @@
+// Читающие соединения закрываются вместе с потоком: короткие рабочие потоки
+// (std::async при импорте и в аналитике) не оставляют открытых соединений
+#include "check.h"
+#include "../include/core/DatabaseManager.h"
+#include "../include/core/SchemaMigrator.h"
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+int main() {
+    auto& db = DatabaseManager::instance();
+    db.connect(check::temp_db("read_connections"));
+    SchemaMigrator(db).migrate();
+    db.execute("INSERT INTO seats (type, status, hardware_spec) VALUES (0, 0, '')");
+
+    const auto read = [&db] {
+        return db.reader().fetch_all("SELECT COUNT(*) FROM seats").at(0).get_int(0);
+    };
+
+    // После join поток уже завершён, его соединение закрыто
+    std::vector<std::thread> threads;
+    for(int i = 0; i < 16; ++i) {
+        threads.emplace_back([&] { CHECK_EQ(read(), 1); });
+    }
+    for(auto& thread : threads) thread.join();
+    CHECK_EQ(db.reader_count(), size_t(0));
+
+    // Поток std::async завершается чуть позже, чем готов результат
+    for(int round = 0; round < 4; ++round) {
+        std::vector<std::future<int>> tasks;
+        for(int i = 0; i < 16; ++i) tasks.push_back(std::async(std::launch::async, read));
+        for(auto& task : tasks) CHECK_EQ(task.get(), 1);
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while(db.reader_count() != 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK_EQ(db.reader_count(), size_t(0));
+
+    // Соединение текущего потока живёт до release_reader
+    CHECK_EQ(read(), 1);
+    CHECK_EQ(db.reader_count(), size_t(1));
+    db.release_reader();
+    CHECK_EQ(db.reader_count(), size_t(0));
+
+    db.disconnect();
+    return check::result();
+}
@@ -0,0 +1,64 @@
+// Пакетное бронирование: запрос с неизвестным клиентом или строка,
+// отклонённая БД, получают свою ошибку, остальные запросы пакета проходят
+#include "check.h"
+#include "../include/core/ClubSystem.h"
+#include "../include/core/DatabaseManager.h"
+#include <ctime>
+
+namespace {
+
+int reservation_count() {
+    return DatabaseManager::instance().fetch_all("SELECT COUNT(*) FROM reservations").at(0).get_int(0);
+}
+
+}
+
+int main() {
+    const std::string path = check::temp_db("reservation_batch");
+    ClubSystem system;
+    system.initialize(path);
+    auto& reservations = system.reservations();
+    const Client client = system.create_client("Иван Петров", "+79990000001");
+    const int seat_id = system.seats()->begin()->id();
+    const time_t hour = 3600;
+    const time_t base = std::time(nullptr) / hour * hour + 24 * hour;
+
+    // Неизвестный клиент отсекается до транзакции
+    auto results = reservations.create_reservations({
+        {client.id(), seat_id, base, base + hour},
+        {client.id() + 1000, seat_id, base + 2 * hour, base + 3 * hour},
+        {client.id(), seat_id, base + 4 * hour, base + 5 * hour},
+    });
+    CHECK_EQ(results.size(), size_t(3));
+    CHECK(results[0].ok());
+    CHECK(!results[1].ok());
+    CHECK(results[1].error.find("Client not found") != std::string::npos);
+    CHECK(results[2].ok());
+    CHECK_EQ(reservation_count(), 2);
+
+    // Строку отклоняет БД: откатывается только она, её слот остаётся свободным
+    DatabaseManager::instance().execute(
+        "CREATE TRIGGER reject_reservation BEFORE INSERT ON reservations "
+        "WHEN NEW.start_time = " + std::to_string(base + 8 * hour) + " "
+        "BEGIN SELECT RAISE(ABORT, 'rejected slot'); END");
+    results = reservations.create_reservations({
+        {client.id(), seat_id, base + 6 * hour, base + 7 * hour},
+        {client.id(), seat_id, base + 8 * hour, base + 9 * hour},
+        {client.id(), seat_id, base + 10 * hour, base + 11 * hour},
+    });
+    CHECK(results[0].ok());
+    CHECK(!results[1].ok());
+    CHECK(results[1].error.find("rejected slot") != std::string::npos);
+    CHECK(results[2].ok());
+    CHECK_EQ(reservation_count(), 4);
+    CHECK(reservations.is_available(seat_id, {base + 8 * hour, base + 9 * hour}));
+    CHECK_EQ(reservations.find_reservations(client.id(), -1, Reservation::Status::ANY).size(), size_t(4));
+
+    DatabaseManager::instance().execute("DROP TRIGGER reject_reservation");
+    results = reservations.create_reservations({{client.id(), seat_id, base + 8 * hour, base + 9 * hour}});
+    CHECK(results.at(0).ok());
+    CHECK_EQ(reservation_count(), 5);
+
+    system.shutdown();
+    return check::result();
+}
@@ -0,0 +1,99 @@
+// Продажа, которую БД отклоняет, не держит журнал: она откладывается, её
+// итоги и списание отменяются, остальные продажи записываются. Временная
+// ошибка БД продажи не теряет.
+#include "check.h"
+#include "../include/core/ClubSystem.h"
+#include "../include/core/DatabaseManager.h"
+#include <chrono>
+#include <sqlite3.h>
+#include <thread>
+
+namespace {
+
+constexpr int poison = 13;      // Количество, на котором срабатывает триггер
+constexpr int initial_stock = 1000;
+
+bool drained(const SalesLedger& ledger) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+    while(ledger.pending() != 0) {
+        if(std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return true;
+}
+
+int db_int(const std::string& query, const std::vector<DatabaseManager::Value>& params = {}) {
+    return DatabaseManager::instance().fetch_all(query, params).at(0).get_int(0);
+}
+
+}
+
+int main() {
+    const std::string path = check::temp_db("sales_ledger");
+    int product_id = 0;
+    int sold = 0;
+    {
+        ClubSystem system;
+        system.initialize(path);
+        system.add_product(Product(0, "Cola", Product::Category::Drink, 1.5, initial_stock));
+        product_id = system.get_products().at(0).id();
+        DatabaseManager::instance().execute(
+            "CREATE TRIGGER poison_sale BEFORE INSERT ON sales WHEN NEW.quantity = 13 "
+            "BEGIN SELECT RAISE(ABORT, 'poison sale'); END");
+
+        // Отравленная продажа среди обычных: отказ получает только она,
+        // товар и итоги возвращаются
+        CHECK(system.sell_product(product_id, poison));
+        for(int i = 0; i < 50; ++i) CHECK(system.sell_product(product_id, 1));
+        sold = 50;
+        CHECK(drained(system.sales()));
+        const auto rejected = system.sales().rejected();
+        CHECK_EQ(rejected.size(), size_t(1));
+        CHECK_EQ(rejected.at(0).sale.quantity, poison);
+        CHECK(rejected.at(0).error.find("poison sale") != std::string::npos);
+        CHECK_EQ(system.product_stock(product_id), initial_stock - sold);
+        CHECK_EQ(system.sales().total().quantity, int64_t(sold));
+        CHECK_EQ(system.sales().product_totals(product_id).sales, int64_t(sold));
+        CHECK_EQ(db_int("SELECT SUM(quantity) FROM sales"), sold);
+        CHECK_EQ(db_int("SELECT stock FROM products WHERE id = ?", {product_id}), initial_stock - sold);
+
+        // Журнал из одной отравленной продажи тоже не висит
+        CHECK(system.sell_product(product_id, poison));
+        CHECK(drained(system.sales()));
+        CHECK_EQ(system.sales().rejected().size(), size_t(2));
+        CHECK_EQ(system.product_stock(product_id), initial_stock - sold);
+
+        // БД занята другим соединением дольше busy_timeout: продажи ждут в
+        // кольце и записываются, когда она освобождается
+        sqlite3* other = nullptr;
+        CHECK(sqlite3_open(path.c_str(), &other) == SQLITE_OK);
+        CHECK(sqlite3_exec(other, "BEGIN EXCLUSIVE", nullptr, nullptr, nullptr) == SQLITE_OK);
+        for(int i = 0; i < 5; ++i) CHECK(system.sell_product(product_id, 2));
+        sold += 10;
+        std::this_thread::sleep_for(std::chrono::seconds(6));
+        CHECK(system.sales().pending() > 0);
+        CHECK(sqlite3_exec(other, "COMMIT", nullptr, nullptr, nullptr) == SQLITE_OK);
+        sqlite3_close(other);
+        CHECK(drained(system.sales()));
+        CHECK_EQ(system.sales().rejected().size(), size_t(2));
+        CHECK_EQ(db_int("SELECT SUM(quantity) FROM sales"), sold);
+
+        // Отказ при остановке тоже отменяет списание, shutdown() не падает
+        CHECK(system.sell_product(product_id, poison));
+        bool stopped = true;
+        try {
+            system.shutdown();
+        } catch(...) {
+            stopped = false;
+        }
+        CHECK(stopped);
+        CHECK_EQ(system.product_stock(product_id), initial_stock - sold);
+    }
+
+    // В БД остаток сходится со строками продаж
+    DatabaseManager::instance().connect(path);
+    CHECK_EQ(db_int("SELECT SUM(quantity) FROM sales"), sold);
+    CHECK_EQ(db_int("SELECT stock FROM products WHERE id = ?", {product_id}), initial_stock - sold);
+    DatabaseManager::instance().disconnect();
+    return check::result();
+}
@@ -0,0 +1,103 @@
+// Кассы продают товар до нуля: продано ровно столько, сколько было на
+// складе, остаток ни в какой момент не уходит ниже нуля
+#include "check.h"
+#include "../include/core/ClubSystem.h"
+#include "../include/core/DatabaseManager.h"
+#include "../include/core/StockCounters.h"
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int terminals = 4;
+constexpr int initial_stock = 20000;
+
+}
+
+int main() {
+    // Счётчики: покупки по 1-3 штуки, часть резервов отменяется
+    StockCounters counters;
+    counters.set(7, initial_stock);
+    std::atomic<bool> done{false};
+    std::atomic<long> negative{0};
+    std::thread watcher([&] {
+        while(!done) {
+            const int available = counters.available(7);
+            const int on_hand = counters.on_hand(7);
+            if(available < 0 || on_hand < 0) ++negative;
+        }
+    });
+
+    std::atomic<int> sold{0};
+    std::vector<std::thread> threads;
+    for(int t = 0; t < terminals; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937 random(t);
+            while(counters.available(7) > 0) {
+                const int quantity = 1 + static_cast<int>(random() % 3);
+                if(!counters.reserve(7, quantity)) continue;
+                if(random() % 10 == 0) {
+                    counters.release(7, quantity);
+                    continue;
+                }
+                counters.commit(7, quantity);
+                sold += quantity;
+            }
+            // Остаток меньше любой покупки - добираем по одной
+            while(counters.reserve(7, 1)) {
+                counters.commit(7, 1);
+                ++sold;
+            }
+        });
+    }
+    for(auto& thread : threads) thread.join();
+    done = true;
+    watcher.join();
+
+    CHECK_EQ(sold.load(), initial_stock);
+    CHECK_EQ(negative.load(), 0L);
+    CHECK_EQ(counters.available(7), 0);
+    CHECK_EQ(counters.on_hand(7), 0);
+    CHECK(!counters.reserve(7, 1));
+
+    // ClubSystem: кассы продают последнюю партию, журнал доходит до БД
+    const std::string path = check::temp_db("stock_counters");
+    constexpr int club_stock = 3000;
+    int product_id = 0;
+    {
+        ClubSystem system;
+        system.initialize(path);
+        DatabaseManager::instance().set_group_commit({true, 64, std::chrono::milliseconds(2)});
+        system.add_product(Product(0, "Cola", Product::Category::Drink, 1.5, club_stock));
+        product_id = system.get_products().at(0).id();
+
+        std::atomic<int> club_sold{0};
+        std::atomic<long> club_negative{0};
+        threads.clear();
+        for(int t = 0; t < terminals; ++t) {
+            threads.emplace_back([&] {
+                while(system.sell_product(product_id, 1)) {
+                    ++club_sold;
+                    if(system.product_stock(product_id) < 0) ++club_negative;
+                }
+            });
+        }
+        for(auto& thread : threads) thread.join();
+
+        CHECK_EQ(club_sold.load(), club_stock);
+        CHECK_EQ(club_negative.load(), 0L);
+        CHECK_EQ(system.product_stock(product_id), 0);
+        CHECK(!system.sell_product(product_id, 1));
+        system.shutdown();
+    }
+
+    DatabaseManager::instance().connect(path);
+    auto& db = DatabaseManager::instance();
+    CHECK_EQ(db.fetch_all("SELECT stock FROM products WHERE id = ?", {product_id}).at(0).get_int(0), 0);
+    CHECK_EQ(db.fetch_all("SELECT SUM(quantity) FROM sales WHERE product_id = ?", {product_id}).at(0).get_int(0),
+             club_stock);
+    db.disconnect();
+    return check::result();
+}
@@ -0,0 +1,106 @@
+// Приведение к нижнему регистру (Utf8::fold) и поиск TrigramIndex: запросы
+// любой длины против полного перебора, разделитель полей, замена и удаление
+#include "check.h"
+#include "../include/core/TrigramIndex.h"
+#include "../include/core/Utf8.h"
+#include <algorithm>
+#include <map>
+#include <random>
+
+namespace {
+
+std::vector<int> brute_force(const std::map<int, std::vector<std::string>>& documents,
+                             const std::string& query) {
+    const std::string needle = Utf8::fold(query);
+    std::vector<int> result;
+    for(const auto& [id, fields] : documents) {
+        for(const auto& field : fields) {
+            if(Utf8::fold(field).find(needle) != std::string::npos) {
+                result.push_back(id);
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+}
+
+int main() {
+    // Кириллица, включая Ё и Ѐ..Џ, Latin-1 без знака умножения, ASCII
+    CHECK(Utf8::fold(U'А') == U'а');
+    CHECK(Utf8::fold(U'Я') == U'я');
+    CHECK(Utf8::fold(U'Ё') == U'ё');
+    CHECK(Utf8::fold(U'Ђ') == U'ђ');
+    CHECK(Utf8::fold(U'ё') == U'ё');
+    CHECK(Utf8::fold(U'À') == U'à');
+    CHECK(Utf8::fold(char32_t(0xD7)) == char32_t(0xD7));
+    CHECK(Utf8::fold(U'Q') == U'q');
+    CHECK_EQ(Utf8::fold("ИВАН Пётр ЁЛКИН"), std::string("иван пётр ёлкин"));
+    CHECK_EQ(Utf8::fold("Mixed Кейс 42"), std::string("mixed кейс 42"));
+    CHECK(Utf8::fold_decode("ЖЁЛТЫЙ") == U"жёлтый");
+
+    // Подстрока на стыке полей не находится, внутри поля - в любом регистре
+    TrigramIndex index;
+    index.add(1, {"Иван Петров", "+79990000001"});
+    CHECK(index.search("ПЕТР") == std::vector<int>{1});
+    CHECK(index.search("вп").empty());
+    CHECK(index.search("в+").empty());
+    CHECK(index.search("ов+7").empty());
+    CHECK(index.search("П") == std::vector<int>{1});
+    CHECK(index.search("01") == std::vector<int>{1});
+
+    // Повторное добавление заменяет тексты документа, удаление убирает его
+    index.add(1, {"Иван Сидоров", "ivan@mail.ru"});
+    CHECK(index.search("петр").empty());
+    CHECK(index.search("+7").empty());
+    CHECK(index.search("сидор") == std::vector<int>{1});
+    CHECK(index.search("@") == std::vector<int>{1});
+    CHECK_EQ(index.size(), size_t(1));
+    index.remove(1);
+    CHECK(index.search("и").empty());
+    CHECK(index.search("сидор").empty());
+    CHECK_EQ(index.size(), size_t(0));
+
+    // Случайные документы: запросы из 1-4 символов совпадают с перебором
+    const std::vector<std::string> names = {"Иван", "Пётр", "Анна", "Ёлкин", "Яна", "Олег", "Юлия"};
+    const std::vector<std::string> surnames = {"Петров", "Иванова", "Смирнов", "Ёжиков", "Сидоров"};
+    std::mt19937 random(7);
+    std::map<int, std::vector<std::string>> documents;
+    for(int id = 1; id <= 3000; ++id) {
+        std::vector<std::string> fields = {
+            names[random() % names.size()] + " " + surnames[random() % surnames.size()],
+            "+7999" + std::to_string(random() % 10000000)
+        };
+        index.add(id, {fields[0], fields[1]});
+        documents[id] = std::move(fields);
+    }
+    for(int id = 1; id <= 3000; id += 7) {
+        index.remove(id);
+        documents.erase(id);
+    }
+    for(int id = 2; id <= 3000; id += 11) {
+        if(!documents.count(id)) continue;
+        documents[id][0] = names[random() % names.size()] + " " + surnames[random() % surnames.size()];
+        index.add(id, {documents[id][0], documents[id][1]});
+    }
+
+    for(int q = 0; q < 400; ++q) {
+        const auto& document = std::next(documents.begin(), random() % documents.size())->second;
+        const std::u32string field = Utf8::decode(document[random() % 2]);
+        const size_t length = 1 + random() % 4;
+        const size_t start = random() % (field.size() - length + 1);
+        std::string query;
+        for(char32_t c : field.substr(start, length)) {
+            // Запрос в верхнем регистре: для кириллицы и ASCII без учёта Ё
+            if(random() % 2 && c >= U'а' && c <= U'я') c -= 0x20;
+            else if(random() % 2 && c >= U'a' && c <= U'z') c -= 0x20;
+            Utf8::append(query, c);
+        }
+        CHECK(index.search(query) == brute_force(documents, query));
+    }
+    CHECK(index.search("") == brute_force(documents, ""));
+    CHECK(index.search("щ").empty());
+
+    return check::result();
+}